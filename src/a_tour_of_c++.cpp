@@ -1,3 +1,8 @@
+#include <print>
+#include <string_view>
+
+#include "benchmark/benchmark.hpp"
+
 namespace capitulo_1 {
 void main();
 }
@@ -50,22 +55,63 @@ namespace capitulo_18 {
 void main();
 }
 
-int main(int, char*[]) {
-    // capitulo_1::main();
-    // capitulo_2::main();
-    // capitulo_3::main();
-    // capitulo_4::main();
-    // capitulo_5::main();
-    // capitulo_6::main();
-    // capitulo_7::main();
-    // capitulo_8::main();
-    // capitulo_10::main();
-    // capitulo_11::main();
-    // capitulo_12::main();
-    // capitulo_13::main();
-    // capitulo_14::main();
-    // capitulo_15::main();
-    // capitulo_16::main();
-    // capitulo_17::main();
-    capitulo_18::main();
+// cada capítulo é selecionado pelo nome na linha de comando, em vez de se
+// comentar/descomentar as chamadas e recompilar o programa.
+struct Capitulo {
+    std::string_view name;
+    void (*main)();
 };
+constexpr Capitulo capitulos[]{
+    {"capitulo_1", capitulo_1::main},
+    {"capitulo_2", capitulo_2::main},
+    {"capitulo_3", capitulo_3::main},
+    {"capitulo_4", capitulo_4::main},
+    {"capitulo_5", capitulo_5::main},
+    {"capitulo_6", capitulo_6::main},
+    {"capitulo_7", capitulo_7::main},
+    {"capitulo_8", capitulo_8::main},
+    {"capitulo_10", capitulo_10::main},
+    {"capitulo_11", capitulo_11::main},
+    {"capitulo_12", capitulo_12::main},
+    {"capitulo_13", capitulo_13::main},
+    {"capitulo_14", capitulo_14::main},
+    {"capitulo_15", capitulo_15::main},
+    {"capitulo_16", capitulo_16::main},
+    {"capitulo_17", capitulo_17::main},
+    {"capitulo_18", capitulo_18::main},
+};
+
+void usage() {
+    std::println("uso: a_tour_of_c++ capitulo_N [capitulo_M ...]");
+    std::println("     a_tour_of_c++ --bench [opções] [filtro...]");
+    std::println("capítulos disponíveis:");
+    for (const auto& c : capitulos) {
+        std::println("    {}", c.name);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string_view{argv[1]} == "--bench") {
+        benchmark::register_capitulos();
+        return benchmark::main(argc - 1, argv + 1);
+    }
+    if (argc == 1) {
+        usage();
+        return 0;
+    }
+    for (int i = 1; i < argc; i++) {
+        const Capitulo* capitulo = nullptr;
+        for (const auto& c : capitulos) {
+            if (c.name == argv[i]) {
+                capitulo = &c;
+            }
+        }
+        if (!capitulo) {
+            std::println("capítulo desconhecido: {}", argv[i]);
+            usage();
+            return 1;
+        }
+        capitulo->main();
+    }
+    return 0;
+}
@@ -0,0 +1,8 @@
+#include "benchmark/benchmark.hpp"
+
+// driver do executável 'a_tour_of_c++_bench': aceita as mesmas opções do modo
+// 'a_tour_of_c++ --bench'.
+int main(int argc, char* argv[]) {
+    benchmark::register_capitulos();
+    return benchmark::main(argc, argv);
+}
@@ -0,0 +1,186 @@
+#include "benchmark/alloc_counter.hpp"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+namespace benchmark {
+namespace {
+// 'constinit' garante inicialização estática: o ponteiro pode ser lido por
+// 'operator new' antes mesmo de 'main'. os escopos são criados e destruídos
+// pela thread que mede; as demais apenas leem o ponteiro.
+constinit std::atomic<AllocScope*> active{nullptr};
+// threads dentro de 'record_*' com um escopo em mãos: o destrutor do escopo
+// espera por elas antes de deixar de existir.
+constinit std::atomic<int> recording{0};
+
+constexpr auto relaxed = std::memory_order_relaxed;
+
+// 'f(scope)' com o escopo ativo, que não será destruído durante a chamada.
+// sem escopo, apenas uma leitura; com escopo, as operações 'seq_cst' em
+// 'recording' e 'active' garantem que, ou o destrutor vê esta thread em
+// 'recording', ou esta thread já vê o escopo seguinte.
+template <typename F>
+void with_active_scope(F f) {
+    if (!active.load(relaxed)) {
+        return;
+    }
+    recording.fetch_add(1);
+    if (auto* scope = active.load()) {
+        f(scope);
+    }
+    recording.fetch_sub(1, std::memory_order_release);
+}
+}  // namespace
+
+AllocScope::AllocScope(std::string_view name)
+    : m_name{name}, m_parent{active.load()} {
+    active.store(this);
+}
+
+AllocScope::~AllocScope() {
+    active.store(m_parent);
+    while (recording.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+AllocStats AllocScope::stats() const {
+    return {m_counters.allocations.load(relaxed),
+            m_counters.frees.load(relaxed),
+            m_counters.bytes_allocated.load(relaxed),
+            m_counters.bytes_freed.load(relaxed),
+            m_counters.live_bytes.load(relaxed),
+            m_counters.peak_live_bytes.load(relaxed)};
+}
+
+// o tamanho é obtido por 'malloc_usable_size' tanto na alocação quanto na
+// liberação, pois nem todo 'delete' recebe o tamanho do objeto.
+void AllocScope::record_allocation(void* p) {
+    with_active_scope([p](AllocScope* scope) {
+        const auto bytes = malloc_usable_size(p);
+        for (auto* s = scope; s; s = s->m_parent) {
+            auto& c = s->m_counters;
+            c.allocations.fetch_add(1, relaxed);
+            c.bytes_allocated.fetch_add(bytes, relaxed);
+            const std::int64_t live =
+                c.live_bytes.fetch_add(bytes, relaxed) + std::int64_t(bytes);
+            std::int64_t peak = c.peak_live_bytes.load(relaxed);
+            while (live > peak && !c.peak_live_bytes.compare_exchange_weak(
+                                      peak, live, relaxed)) {
+            }
+        }
+    });
+}
+
+void AllocScope::record_free(void* p) {
+    if (!p) {
+        return;
+    }
+    with_active_scope([p](AllocScope* scope) {
+        const auto bytes = malloc_usable_size(p);
+        for (auto* s = scope; s; s = s->m_parent) {
+            auto& c = s->m_counters;
+            c.frees.fetch_add(1, relaxed);
+            c.bytes_freed.fetch_add(bytes, relaxed);
+            c.live_bytes.fetch_sub(bytes, relaxed);
+        }
+    });
+}
+
+}  // namespace benchmark
+
+namespace {
+using benchmark::AllocScope;
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    size = std::max<std::size_t>(size, 1);
+    while (true) {
+        void* p = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+                      ? std::aligned_alloc(
+                            alignment,
+                            (size + alignment - 1) / alignment * alignment)
+                      : std::malloc(size);
+        if (p) {
+            AllocScope::record_allocation(p);
+            return p;
+        }
+        // comportamento exigido pelo padrão: invocar o 'new_handler' até que
+        // a alocação seja bem sucedida, ou falhar se não houver handler.
+        auto handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+void* allocate_nothrow(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return allocate(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void deallocate(void* p) noexcept {
+    AllocScope::record_free(p);
+    std::free(p);
+}
+
+constexpr std::size_t default_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}  // namespace
+
+// substituições dos operadores globais ('replaceable allocation functions').
+void* operator new(std::size_t n) { return allocate(n, default_alignment); }
+void* operator new[](std::size_t n) { return allocate(n, default_alignment); }
+void* operator new(std::size_t n, std::align_val_t a) {
+    return allocate(n, std::size_t(a));
+}
+void* operator new[](std::size_t n, std::align_val_t a) {
+    return allocate(n, std::size_t(a));
+}
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    return allocate_nothrow(n, default_alignment);
+}
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    return allocate_nothrow(n, default_alignment);
+}
+void* operator new(std::size_t n, std::align_val_t a,
+                   const std::nothrow_t&) noexcept {
+    return allocate_nothrow(n, std::size_t(a));
+}
+void* operator new[](std::size_t n, std::align_val_t a,
+                     const std::nothrow_t&) noexcept {
+    return allocate_nothrow(n, std::size_t(a));
+}
+
+void operator delete(void* p) noexcept { deallocate(p); }
+void operator delete[](void* p) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    deallocate(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+void operator delete(void* p, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+// contabilização de alocações por escopo nomeado. 'alloc_counter.cpp'
+// substitui os 'operator new'/'operator delete' globais: toda alocação feita
+// enquanto um 'AllocScope' estiver ativo é atribuída a este escopo e aos
+// escopos que o envolvem.
+//
+// o escopo ativo é do processo, e não da thread: alocações feitas pelas
+// threads de um kernel (as do OpenMP, as de 'std::async') também são contadas.
+// em contrapartida, alocações de threads sem relação com o kernel que
+// estiverem rodando ao mesmo tempo também entram na conta. sem escopo ativo, o
+// custo adicional é apenas a leitura de um ponteiro atômico.
+namespace benchmark {
+
+struct AllocStats {
+    std::uint64_t allocations{0};
+    std::uint64_t frees{0};
+    std::uint64_t bytes_allocated{0};
+    std::uint64_t bytes_freed{0};
+    std::int64_t live_bytes{0};  // pode ser negativo, se o escopo liberar
+                                 // memória alocada antes de seu início.
+    std::int64_t peak_live_bytes{0};
+};
+
+class AllocScope {
+   public:
+    explicit AllocScope(std::string_view name);
+    ~AllocScope();
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+    std::string_view name() const { return m_name; }
+    // valores atuais; com outras threads ainda alocando, é uma aproximação.
+    AllocStats stats() const;
+
+    // chamados pelos operadores substituídos.
+    static void record_allocation(void* p);
+    static void record_free(void* p);
+
+   private:
+    // os campos de 'AllocStats', atualizados por várias threads.
+    struct Counters {
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> frees{0};
+        std::atomic<std::uint64_t> bytes_allocated{0};
+        std::atomic<std::uint64_t> bytes_freed{0};
+        std::atomic<std::int64_t> live_bytes{0};
+        std::atomic<std::int64_t> peak_live_bytes{0};
+    };
+
+    std::string_view m_name;
+    Counters m_counters;
+    AllocScope* m_parent;
+};
+
+}  // namespace benchmark
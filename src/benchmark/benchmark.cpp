@@ -0,0 +1,446 @@
+#include "benchmark/benchmark.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <print>
+#include <stdexcept>
+#include <utility>
+
+#ifndef A_TOUR_BUILD
+#define A_TOUR_BUILD "desconhecido"
+#endif
+
+namespace benchmark {
+const char* const build = A_TOUR_BUILD;
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<Entry>& registry() {
+    static std::vector<Entry> entries;  // inicializado no primeiro uso, o que
+                                        // evita problemas de ordem de
+                                        // inicialização estática.
+    return entries;
+}
+
+void add(std::string name, Kernel kernel) {
+    registry().push_back({std::move(name), std::move(kernel), {}});
+}
+
+void add(std::string name, Kernel kernel, Fixture fixture) {
+    registry().push_back(
+        {std::move(name), std::move(kernel), std::move(fixture)});
+}
+
+namespace {
+std::vector<KernelValue>& kernel_values() {
+    static std::vector<KernelValue> values;
+    return values;
+}
+}  // namespace
+
+void set_value(std::string_view name, double value) {
+    auto& values = kernel_values();
+    auto it = std::ranges::find(values, name, &KernelValue::name);
+    if (it != values.end()) {
+        it->value = value;
+    } else {
+        values.push_back({std::string{name}, value});
+    }
+}
+
+namespace {
+template <typename T>
+T parse_number(std::string_view option, std::string_view text) {
+    T value{};
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(),
+                                     value);
+    if (ec != std::errc{} || ptr != text.data() + text.size()) {
+        throw std::invalid_argument{
+            std::format("valor inválido para '{}': '{}'", option, text)};
+    }
+    return value;
+}
+
+void usage() {
+    std::println(
+        "uso: --bench [--list] [--perf] [--alloc] [--trace] [--warmup=N] "
+        "[--reps=N] [--min-time=ms] [--json=arquivo] [filtro...]");
+}
+
+double elapsed_ns(Clock::time_point start, Clock::time_point stop) {
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+// percentil pelo método 'nearest rank', sobre amostras já ordenadas.
+double percentile(const std::vector<double>& sorted, double p) {
+    auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+double per_iteration(std::uint64_t total, const Result& r) {
+    return double(total) / (double(r.iterations) * r.repetitions);
+}
+
+bool has_allocs(const Result& r) { return r.allocs.has_value(); }
+
+bool has_traces(const Result& r) { return !r.traces.empty(); }
+
+bool has_values(const Result& r) { return !r.values.empty(); }
+
+bool has_counters(const Result& r) {
+    return std::ranges::any_of(r.counters.available, std::identity{});
+}
+
+std::string json_escape(std::string_view s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            // caracteres de controle não podem aparecer crus numa string.
+            out += std::format("\\u{:04x}", static_cast<unsigned char>(c));
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// JSON não tem 'nan' nem 'inf': valores não finitos viram 'null'.
+std::string json_number(double value) {
+    return std::isfinite(value) ? std::format("{}", value) : "null";
+}
+}  // namespace
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg{argv[i]};
+        auto value = [arg] { return arg.substr(arg.find('=') + 1); };
+        if (arg == "--list") {
+            options.list = true;
+        } else if (arg == "--perf") {
+            options.perf = true;
+        } else if (arg == "--alloc") {
+            options.alloc = true;
+        } else if (arg == "--trace") {
+            options.trace = true;
+        } else if (arg.starts_with("--warmup=")) {
+            options.warmup = parse_number<int>("--warmup", value());
+        } else if (arg.starts_with("--reps=")) {
+            options.repetitions = parse_number<int>("--reps", value());
+        } else if (arg.starts_with("--min-time=")) {
+            options.min_sample_ms =
+                parse_number<double>("--min-time", value());
+        } else if (arg.starts_with("--json=")) {
+            options.json_path = value();
+        } else if (arg.starts_with("--")) {
+            usage();
+            throw std::invalid_argument{
+                std::format("opção desconhecida: {}", arg)};
+        } else {
+            options.filters.emplace_back(arg);
+        }
+    }
+    if (options.repetitions <= 0 || options.warmup < 0) {
+        throw std::invalid_argument{
+            "--reps deve ser positivo e --warmup não negativo"};
+    }
+    return options;
+}
+
+bool selected(std::string_view name, const Options& options) {
+    if (options.filters.empty()) {
+        return true;
+    }
+    return std::ranges::any_of(options.filters, [name](const auto& f) {
+        return name.find(f) != std::string_view::npos;
+    });
+}
+
+Result measure(const Entry& entry, const Options& options,
+               PerfCounters* perf) {
+    kernel_values().clear();
+    if (entry.fixture.setup) {
+        entry.fixture.setup();
+    }
+    for (int i = 0; i < options.warmup; i++) {
+        entry.kernel();
+    }
+    // calibração: kernels muito curtos são repetidos dentro de uma mesma
+    // amostra, para que a resolução do relógio não domine a medição.
+    const double min_sample_ns = options.min_sample_ms * 1e6;
+    long iterations = 1;
+    while (true) {
+        auto start = Clock::now();
+        for (long i = 0; i < iterations; i++) {
+            entry.kernel();
+        }
+        double t = elapsed_ns(start, Clock::now());
+        if (t >= min_sample_ns || iterations >= (1L << 30)) {
+            break;
+        }
+        // estima quantas iterações são necessárias, com alguma folga.
+        long next =
+            t > 0 ? static_cast<long>(iterations * 1.2 * min_sample_ns / t)
+                  : iterations * 10;
+        iterations = std::clamp(next, iterations + 1, iterations * 10);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    CounterValues counters;
+    std::optional<AllocScope> alloc_scope;
+    if (options.alloc) {
+        alloc_scope.emplace(entry.name);
+    }
+    if (options.trace) {
+        reset_traces();  // descarta o aquecimento e a calibração
+    }
+    // só o laço é cronometrado: com '--perf', habilitar e ler os contadores
+    // (chamadas de sistema) fica fora da amostra, e os tempos são comparáveis
+    // aos de uma execução sem '--perf'.
+    auto timed_loop = [&entry, iterations] {
+        auto start = Clock::now();
+        for (long i = 0; i < iterations; i++) {
+            entry.kernel();
+        }
+        return elapsed_ns(start, Clock::now());
+    };
+    for (int r = 0; r < options.repetitions; r++) {
+        double t;
+        if (perf) {
+            PerfScope scope{*perf, counters};
+            t = timed_loop();
+        } else {
+            t = timed_loop();
+        }
+        samples.push_back(t / iterations);
+    }
+    for (auto& value : counters.values) {
+        value /= double(iterations) * options.repetitions;
+    }
+    std::optional<AllocStats> allocs;
+    if (alloc_scope) {
+        allocs = alloc_scope->stats();
+        alloc_scope.reset();
+    }
+    std::vector<TraceReport> traces;
+    if (options.trace) {
+        traces = trace_report();
+    }
+    if (entry.fixture.teardown) {
+        entry.fixture.teardown();
+    }
+    std::ranges::sort(samples);
+    const double mean =
+        std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    return {entry.name,
+            iterations,
+            options.repetitions,
+            samples.front(),
+            percentile(samples, 0.5),
+            percentile(samples, 0.99),
+            mean,
+            counters,
+            allocs,
+            std::move(traces),
+            std::exchange(kernel_values(), {})};
+}
+
+std::vector<Result> run(const Options& options) {
+    std::unique_ptr<PerfCounters> perf;
+    if (options.perf) {
+        perf = std::make_unique<PerfCounters>();
+        if (!perf->any_available()) {
+            std::println(std::cerr,
+                         "perf_event_open indisponível (verifique "
+                         "/proc/sys/kernel/perf_event_paranoid); "
+                         "seguindo sem contadores");
+            perf.reset();
+        }
+    }
+    std::vector<Result> results;
+    for (const auto& entry : registry()) {
+        if (selected(entry.name, options)) {
+            results.push_back(measure(entry, options, perf.get()));
+        }
+    }
+    return results;
+}
+
+void report_text(std::ostream& out, const std::vector<Result>& results) {
+    std::println(out, "compilação: {}", build);
+    std::println(out, "{:<40} {:>10} {:>14} {:>14} {:>14}", "kernel",
+                 "iterações", "min (ns)", "mediana (ns)", "p99 (ns)");
+    for (const auto& r : results) {
+        std::println(out, "{:<40} {:>10} {:>14.1f} {:>14.1f} {:>14.1f}",
+                     r.name, r.iterations, r.min, r.median, r.p99);
+    }
+    if (std::ranges::any_of(results, has_allocs)) {
+        std::println(out, "\n{:<40} {:>14} {:>14} {:>14} {:>14}", "kernel",
+                     "allocs/iter", "frees/iter", "bytes/iter", "pico (bytes)");
+        for (const auto& r : results) {
+            if (!r.allocs) {
+                continue;
+            }
+            std::println(out, "{:<40} {:>14.2f} {:>14.2f} {:>14.1f} {:>14}",
+                         r.name, per_iteration(r.allocs->allocations, r),
+                         per_iteration(r.allocs->frees, r),
+                         per_iteration(r.allocs->bytes_allocated, r),
+                         r.allocs->peak_live_bytes);
+        }
+    }
+    if (std::ranges::any_of(results, has_traces)) {
+        std::println(out, "\n{:<40} {:<24} {:>10} {:>10} {:>10} {:>10}",
+                     "kernel", "tipo", "constr/it", "cópias/it", "moves/it",
+                     "atrib/it");
+        for (const auto& r : results) {
+            for (const auto& t : r.traces) {
+                const auto& c = t.counts;
+                std::println(
+                    out,
+                    "{:<40} {:<24} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}",
+                    r.name, t.type, per_iteration(c.constructions, r),
+                    per_iteration(c.copies, r), per_iteration(c.moves, r),
+                    per_iteration(c.copy_assignments + c.move_assignments, r));
+            }
+        }
+    }
+    if (std::ranges::any_of(results, has_values)) {
+        std::println(out, "\n{:<40} {:<24} {:>14}", "kernel", "valor",
+                     "último");
+        for (const auto& r : results) {
+            for (const auto& v : r.values) {
+                std::println(out, "{:<40} {:<24} {:>14}", r.name, v.name,
+                             v.value);
+            }
+        }
+    }
+    if (std::ranges::none_of(results, has_counters)) {
+        return;
+    }
+    // contadores de hardware, por iteração do kernel.
+    std::print(out, "\n{:<40}", "kernel");
+    for (int c = 0; c < counter_count; c++) {
+        std::print(out, " {:>14}", counter_name(Counter(c)));
+    }
+    std::println(out, "");
+    for (const auto& r : results) {
+        std::print(out, "{:<40}", r.name);
+        for (int c = 0; c < counter_count; c++) {
+            if (r.counters.available[c]) {
+                std::print(out, " {:>14.1f}", r.counters.values[c]);
+            } else {
+                std::print(out, " {:>14}", "-");
+            }
+        }
+        std::println(out, "");
+    }
+}
+
+void report_json(std::ostream& out, const std::vector<Result>& results) {
+    std::println(out, "{{\n  \"build\": \"{}\",\n  \"results\": [",
+                 json_escape(build));
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        std::print(out,
+                   "    {{\"name\": \"{}\", \"iterations\": {}, "
+                   "\"repetitions\": {}, \"min_ns\": {}, \"median_ns\": {}, "
+                   "\"p99_ns\": {}, \"mean_ns\": {}",
+                   json_escape(r.name), r.iterations, r.repetitions,
+                   json_number(r.min), json_number(r.median),
+                   json_number(r.p99), json_number(r.mean));
+        if (has_counters(r)) {
+            std::print(out, ", \"counters\": {{");
+            const char* separator = "";
+            for (int c = 0; c < counter_count; c++) {
+                if (r.counters.available[c]) {
+                    std::print(out, "{}\"{}\": {}", separator,
+                               counter_name(Counter(c)),
+                               json_number(r.counters.values[c]));
+                    separator = ", ";
+                }
+            }
+            std::print(out, "}}");
+        }
+        if (r.allocs) {
+            std::print(out,
+                       ", \"allocs\": {{\"allocations\": {}, \"frees\": {}, "
+                       "\"bytes_allocated\": {}, \"bytes_freed\": {}, "
+                       "\"peak_live_bytes\": {}}}",
+                       r.allocs->allocations, r.allocs->frees,
+                       r.allocs->bytes_allocated, r.allocs->bytes_freed,
+                       r.allocs->peak_live_bytes);
+        }
+        if (has_traces(r)) {
+            std::print(out, ", \"traces\": [");
+            const char* separator = "";
+            for (const auto& t : r.traces) {
+                const auto& c = t.counts;
+                std::print(out,
+                           "{}{{\"type\": \"{}\", \"constructions\": {}, "
+                           "\"copies\": {}, \"moves\": {}, "
+                           "\"copy_assignments\": {}, "
+                           "\"move_assignments\": {}, \"destructions\": {}}}",
+                           separator, json_escape(t.type), c.constructions,
+                           c.copies, c.moves, c.copy_assignments,
+                           c.move_assignments, c.destructions);
+                separator = ", ";
+            }
+            std::print(out, "]");
+        }
+        if (has_values(r)) {
+            std::print(out, ", \"values\": {{");
+            const char* separator = "";
+            for (const auto& v : r.values) {
+                std::print(out, "{}\"{}\": {}", separator, json_escape(v.name),
+                           json_number(v.value));
+                separator = ", ";
+            }
+            std::print(out, "}}");
+        }
+        std::println(out, "}}{}", i + 1 < results.size() ? "," : "");
+    }
+    std::println(out, "  ]\n}}");
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::invalid_argument& err) {
+        std::println(std::cerr, "{}", err.what());
+        return 2;
+    }
+    if (options.list) {
+        for (const auto& entry : registry()) {
+            if (selected(entry.name, options)) {
+                std::println("{}", entry.name);
+            }
+        }
+        return 0;
+    }
+    auto results = run(options);
+    report_text(std::cout, results);
+    if (!options.json_path.empty()) {
+        std::ofstream file{options.json_path};
+        if (!file) {
+            std::println(std::cerr, "não foi possível abrir '{}'",
+                         options.json_path);
+            return 1;
+        }
+        report_json(file, results);
+    }
+    return 0;
+}
+
+}  // namespace benchmark
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/alloc_counter.hpp"
+#include "benchmark/perf_counters.hpp"
+#include "benchmark/traced.hpp"
+
+// registro de 'kernels' (trechos de código quentes dos capítulos) e um
+// executor que realiza aquecimento, repetições cronometradas e relata os
+// tempos mínimo, mediano e p99 em texto e em JSON.
+namespace benchmark {
+
+using Kernel = std::function<void()>;
+
+// preparação e limpeza em torno de toda a medição de um kernel (aquecimento,
+// calibração e amostras), fora dos tempos. ex.: trocar um estado global só
+// enquanto o kernel é medido. qualquer um dos dois pode ser vazio.
+struct Fixture {
+    Kernel setup;
+    Kernel teardown;
+};
+
+struct Entry {
+    std::string name;  // ex.: "capitulo_1/sum/1024"
+    Kernel kernel;
+    Fixture fixture;
+};
+
+// cada 'capitulo_N::benchmarks()' registra os seus kernels por meio de 'add'.
+std::vector<Entry>& registry();
+void add(std::string name, Kernel kernel);
+void add(std::string name, Kernel kernel, Fixture fixture);
+// invoca 'capitulo_N::benchmarks()' de todos os capítulos com kernels.
+void register_capitulos();
+
+// identifica a compilação (ex.: "demo -Og", "bench -O3 -flto") nos relatórios,
+// para que resultados de compilações diferentes possam ser comparados.
+extern const char* const build;
+
+// impede que o compilador descarte o cálculo de um valor que não é utilizado
+// posteriormente (dead code elimination).
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+// valor informado pelo próprio kernel e relatado ao lado dos tempos (ex.:
+// registros descartados por uma fila cheia, que de outro modo apareceriam como
+// ganho de tempo). vale o último valor de cada nome, na medição atual.
+struct KernelValue {
+    std::string name;
+    double value;
+};
+void set_value(std::string_view name, double value);
+
+// dados de entrada criados apenas na primeira execução do kernel (durante o
+// aquecimento): kernels não selecionados pelo filtro não alocam nada, o que
+// importa para entradas do tamanho da DRAM. o objeto é compartilhado por todas
+// as cópias do 'getter' retornado.
+template <typename Make>
+auto lazy(Make make) {
+    using T = decltype(make());
+    struct State {
+        Make make;
+        std::optional<T> value;
+    };
+    auto state = std::make_shared<State>(std::move(make), std::nullopt);
+    return [state]() -> T& {
+        if (!state->value) {
+            state->value.emplace(state->make());
+        }
+        return *state->value;
+    };
+}
+
+struct Options {
+    std::vector<std::string> filters;  // substrings do nome do kernel
+    int warmup{3};
+    int repetitions{30};
+    double min_sample_ms{1.0};  // tempo mínimo de cada amostra
+    std::string json_path;      // vazio: sem relatório JSON
+    bool list{false};
+    bool perf{false};   // contadores de hardware (ver 'perf_counters.hpp')
+    bool alloc{false};  // alocações por kernel (ver 'alloc_counter.hpp')
+    bool trace{false};  // operações de 'Traced<T>' por kernel ('traced.hpp')
+};
+
+struct Result {
+    std::string name;
+    long iterations;  // iterações do kernel por amostra
+    int repetitions;  // número de amostras
+    // tempos por iteração, em nanossegundos.
+    double min;
+    double median;
+    double p99;
+    double mean;
+    // médias por iteração dos contadores de hardware, quando '--perf'.
+    CounterValues counters;
+    // totais de alocação de todas as amostras, quando '--alloc'.
+    std::optional<AllocStats> allocs;
+    // totais de 'Traced<T>' de todas as amostras, por tipo, quando '--trace'.
+    std::vector<TraceReport> traces;
+    // valores de 'set_value', na ordem em que apareceram.
+    std::vector<KernelValue> values;
+};
+
+Options parse_options(int argc, char* argv[]);
+bool selected(std::string_view name, const Options& options);
+Result measure(const Entry& entry, const Options& options,
+               PerfCounters* perf = nullptr);
+std::vector<Result> run(const Options& options);
+
+void report_text(std::ostream& out, const std::vector<Result>& results);
+void report_json(std::ostream& out, const std::vector<Result>& results);
+
+// ponto de entrada do modo benchmark: argv[0] é ignorado.
+int main(int argc, char* argv[]);
+
+}  // namespace benchmark
@@ -0,0 +1,56 @@
+#include "benchmark/benchmark.hpp"
+
+namespace capitulo_1 {
+void benchmarks();
+}
+namespace capitulo_2 {
+void benchmarks();
+}
+namespace capitulo_3 {
+void benchmarks();
+}
+namespace capitulo_4 {
+void benchmarks();
+}
+namespace capitulo_5 {
+void benchmarks();
+}
+namespace capitulo_6 {
+void benchmarks();
+}
+namespace capitulo_7 {
+void benchmarks();
+}
+namespace capitulo_8 {
+void benchmarks();
+}
+namespace capitulo_10 {
+void benchmarks();
+}
+namespace capitulo_12 {
+void benchmarks();
+}
+namespace capitulo_16 {
+void benchmarks();
+}
+namespace capitulo_18 {
+void benchmarks();
+}
+
+namespace benchmark {
+// compartilhado entre 'a_tour_of_c++ --bench' e 'a_tour_of_c++_bench'.
+void register_capitulos() {
+    capitulo_1::benchmarks();
+    capitulo_2::benchmarks();
+    capitulo_3::benchmarks();
+    capitulo_4::benchmarks();
+    capitulo_5::benchmarks();
+    capitulo_6::benchmarks();
+    capitulo_7::benchmarks();
+    capitulo_8::benchmarks();
+    capitulo_10::benchmarks();
+    capitulo_12::benchmarks();
+    capitulo_16::benchmarks();
+    capitulo_18::benchmarks();
+}
+}  // namespace benchmark
@@ -0,0 +1,190 @@
+#include "benchmark/perf_counters.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <print>
+#include <string>
+
+namespace benchmark {
+
+std::string_view counter_name(Counter c) {
+    switch (c) {
+        case Counter::cycles:
+            return "cycles";
+        case Counter::instructions:
+            return "instructions";
+        case Counter::l1d_misses:
+            return "l1d_misses";
+        case Counter::llc_misses:
+            return "llc_misses";
+        case Counter::dtlb_misses:
+            return "dtlb_misses";
+        case Counter::branch_misses:
+            return "branch_misses";
+    }
+    return "?";
+}
+
+CounterValues& CounterValues::operator+=(const CounterValues& other) {
+    for (int i = 0; i < counter_count; i++) {
+        values[i] += other.values[i];
+        available[i] = available[i] || other.available[i];
+    }
+    return *this;
+}
+
+namespace {
+constexpr std::uint64_t cache_miss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// 'group' é o descritor do líder, ou -1 para abrir o próprio líder.
+int open_counter(std::uint32_t type, std::uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group < 0;  // os membros seguem o líder
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid = 0, cpu = -1: a thread atual, em qualquer cpu.
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group,
+                                    PERF_FLAG_FD_CLOEXEC));
+}
+
+struct EventConfig {
+    std::uint32_t type;
+    std::uint64_t config;
+    int group;
+};
+
+constexpr std::array<EventConfig, counter_count> events{{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 0},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 0},
+    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D), 1},
+    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL), 1},
+    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB), 1},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, 1},
+}};
+}  // namespace
+
+PerfCounters::PerfCounters() {
+    // o primeiro contador de cada grupo que abrir é o seu líder; um evento que
+    // não puder ser aberto (inexistente na máquina, ou que não caiba no grupo)
+    // fica de fora, sem impedir os demais.
+    for (int i = 0; i < counter_count; i++) {
+        Group& group = groups[events[i].group];
+        fd[i] = open_counter(events[i].type, events[i].config, group.leader);
+        if (fd[i] < 0) {
+            continue;
+        }
+        if (group.leader < 0) {
+            group.leader = fd[i];
+        }
+        group_of[i] = events[i].group;
+        slot[i] = group.members++;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    // os membros antes dos líderes.
+    for (int i = counter_count - 1; i >= 0; i--) {
+        if (fd[i] >= 0 && fd[i] != groups[group_of[i]].leader) {
+            close(fd[i]);
+        }
+    }
+    for (const Group& group : groups) {
+        if (group.leader >= 0) {
+            close(group.leader);
+        }
+    }
+}
+
+bool PerfCounters::any_available() const {
+    for (const Group& group : groups) {
+        if (group.leader >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PerfCounters::read_group(const Group& group, Reading& reading) {
+    const ssize_t n = read(group.leader, &reading, sizeof(Reading));
+    return n >= ssize_t(3 * sizeof(std::uint64_t));
+}
+
+void PerfCounters::start() {
+    for (Group& group : groups) {
+        if (group.leader < 0) {
+            continue;
+        }
+        if (!read_group(group, group.before)) {
+            group.before = {};
+        }
+        ioctl(group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+CounterValues PerfCounters::stop() {
+    CounterValues result;
+    for (Group& group : groups) {
+        if (group.leader >= 0) {
+            ioctl(group.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+    for (int g = 0; g < group_count; g++) {
+        Group& group = groups[g];
+        Reading after;
+        if (group.leader < 0 || !read_group(group, after)) {
+            continue;
+        }
+        const double enabled = after.time_enabled - group.before.time_enabled;
+        const double running = after.time_running - group.before.time_running;
+        if (running <= 0) {
+            // o grupo abriu, mas o kernel não chegou a agendá-lo (ex.: a pmu
+            // não tem registradores livres): seus contadores ficam como
+            // indisponíveis, com um aviso na primeira vez.
+            if (enabled > 0 && !group.warned) {
+                group.warned = true;
+                std::string names;
+                for (int i = 0; i < counter_count; i++) {
+                    if (fd[i] >= 0 && group_of[i] == g) {
+                        names += names.empty() ? "" : ", ";
+                        names += counter_name(Counter(i));
+                    }
+                }
+                std::println(std::cerr,
+                             "perf: o kernel não agendou o grupo ({}); "
+                             "esses contadores ficam de fora",
+                             names);
+            }
+            continue;
+        }
+        for (int i = 0; i < counter_count; i++) {
+            if (fd[i] < 0 || group_of[i] != g) {
+                continue;
+            }
+            const double value =
+                after.values[slot[i]] - group.before.values[slot[i]];
+            // se o kernel multiplexou o grupo, extrapola-se o valor medido
+            // para todo o tempo em que ele esteve habilitado; a escala é a
+            // mesma para todos os contadores do grupo.
+            result.values[i] = value * enabled / running;
+            result.available[i] = true;
+        }
+    }
+    return result;
+}
+
+}  // namespace benchmark
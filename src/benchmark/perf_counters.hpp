@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// contadores de desempenho de hardware por meio de 'perf_event_open' (Linux).
+// 'PerfCounters' abre os descritores uma única vez; 'PerfScope' é o objeto
+// RAII que habilita os contadores no construtor e, no destructor, acumula o
+// que foi medido na região de código delimitada pelo seu escopo.
+//
+// os contadores formam dois grupos, 'cycles'/'instructions' e as falhas de
+// cache, TLB e desvio: o kernel agenda cada grupo por inteiro, e seis eventos
+// de hardware num só grupo podem não caber nos registradores da pmu (com o
+// watchdog de nmi ocupando um deles), caso em que o grupo abre mas nunca é
+// agendado. dentro de um grupo todos medem a mesma janela de tempo, o que
+// mantém comparáveis as razões entre eles (ex.: 'ipc'); cada grupo é
+// habilitado, desabilitado e lido com uma chamada de sistema cada.
+//
+// só a thread que chama 'start' é medida: as threads do OpenMP (as somas
+// paralelas dos capítulos) não são contadas. 'inherit' as incluiria, mas o
+// kernel recusa 'inherit' junto com 'PERF_FORMAT_GROUP'.
+namespace benchmark {
+
+enum class Counter {
+    cycles,
+    instructions,
+    l1d_misses,
+    llc_misses,
+    dtlb_misses,
+    branch_misses
+};
+constexpr int counter_count = 6;
+
+std::string_view counter_name(Counter c);
+
+struct CounterValues {
+    // valores ajustados pela multiplexação do kernel ('time_enabled' /
+    // 'time_running'). contadores indisponíveis permanecem em zero.
+    std::array<double, counter_count> values{};
+    std::array<bool, counter_count> available{};
+
+    double operator[](Counter c) const { return values[int(c)]; }
+    CounterValues& operator+=(const CounterValues& other);
+};
+
+class PerfCounters {
+   public:
+    PerfCounters();  // contadores que não puderem ser abertos (permissão,
+                     // máquina virtual, etc.) são marcados como indisponíveis.
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool any_available() const;
+    void start();
+    CounterValues stop();
+
+   private:
+    // formato de 'read' no líder com 'PERF_FORMAT_GROUP'.
+    struct Reading {
+        std::uint64_t count;  // membros do grupo
+        std::uint64_t time_enabled;
+        std::uint64_t time_running;
+        std::array<std::uint64_t, counter_count> values;
+    };
+    struct Group {
+        int leader{-1};
+        int members{0};
+        Reading before{};
+        bool warned{false};  // já avisou que o grupo não foi agendado
+    };
+    static constexpr int group_count = 2;
+    static bool read_group(const Group& group, Reading& reading);
+
+    std::array<int, counter_count> fd;
+    // grupo de cada contador, e sua posição em 'Reading::values' (a ordem de
+    // abertura dentro do grupo).
+    std::array<int, counter_count> group_of{};
+    std::array<int, counter_count> slot{};
+    std::array<Group, group_count> groups{};
+};
+
+class PerfScope {
+   public:
+    PerfScope(PerfCounters& counters, CounterValues& total)
+        : counters{counters}, total{total} {
+        counters.start();
+    }
+    ~PerfScope() { total += counters.stop(); }
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+   private:
+    PerfCounters& counters;
+    CounterValues& total;
+};
+
+}  // namespace benchmark
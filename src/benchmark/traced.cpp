@@ -0,0 +1,54 @@
+#include "benchmark/traced.hpp"
+
+#include <cxxabi.h>
+
+#include <cstdlib>
+#include <memory>
+
+namespace benchmark {
+namespace {
+struct Registration {
+    const std::type_info* type;
+    TraceCounts* counts;
+};
+
+// contadores de cada tipo já usado nesta thread. os próprios contadores
+// pertencem a 'detail::trace_counts<T>()'; aqui ficam apenas os endereços.
+thread_local std::vector<Registration> registrations;
+
+std::string demangle(const char* name) {
+    int status = 0;
+    std::unique_ptr<char, void (*)(void*)> res{
+        abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free};
+    return status == 0 ? res.get() : name;
+}
+
+bool touched(const TraceCounts& c) {
+    return c.constructions || c.copies || c.moves || c.copy_assignments ||
+           c.move_assignments || c.destructions;
+}
+}  // namespace
+
+namespace detail {
+void register_trace(const std::type_info& type, TraceCounts& counts) {
+    registrations.push_back({&type, &counts});
+}
+}  // namespace detail
+
+std::vector<TraceReport> trace_report() {
+    std::vector<TraceReport> report;
+    for (const auto& r : registrations) {
+        if (touched(*r.counts)) {
+            report.push_back({demangle(r.type->name()), *r.counts});
+        }
+    }
+    return report;
+}
+
+void reset_traces() {
+    for (const auto& r : registrations) {
+        *r.counts = {};
+    }
+}
+
+}  // namespace benchmark
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+// 'Traced<T>' envolve um valor de tipo 'T' e conta, sem imprimir nada, as
+// construções, cópias, movimentações e destruições feitas com ele. é a versão
+// reutilizável de 'capitulo_3::Box': basta trocar 'T' por 'Traced<T>' num
+// trecho de código para descobrir onde há cópias indesejadas (RVO impedido
+// por 'std::move', captura por valor, etc.).
+//
+// os contadores são 'thread_local' e separados por 'T': o custo por operação
+// é um incremento sem sincronização.
+namespace benchmark {
+
+struct TraceCounts {
+    std::uint64_t constructions{0};  // exceto cópias e movimentações
+    std::uint64_t copies{0};
+    std::uint64_t moves{0};
+    std::uint64_t copy_assignments{0};
+    std::uint64_t move_assignments{0};
+    std::uint64_t destructions{0};
+};
+
+struct TraceReport {
+    std::string type;  // nome de 'T', sem a decoração do compilador
+    TraceCounts counts;
+};
+
+// tipos com alguma operação registrada nesta thread desde o último
+// 'reset_traces()'.
+std::vector<TraceReport> trace_report();
+void reset_traces();
+
+namespace detail {
+void register_trace(const std::type_info& type, TraceCounts& counts);
+
+template <typename T>
+TraceCounts& trace_counts() {
+    constinit thread_local TraceCounts counts{};
+    constinit thread_local bool registered = false;
+    if (!registered) [[unlikely]] {
+        registered = true;
+        register_trace(typeid(T), counts);
+    }
+    return counts;
+}
+}  // namespace detail
+
+template <typename T>
+const TraceCounts& trace_counts() {
+    return detail::trace_counts<T>();
+}
+
+template <typename T>
+class Traced {
+   public:
+    Traced()
+        requires std::default_initializable<T>
+        : m_value() {
+        ++counts().constructions;
+    }
+    template <typename... Args>
+        requires std::constructible_from<T, Args...> &&
+                 (!(std::same_as<std::remove_cvref_t<Args>, Traced> || ...))
+    Traced(Args&&... args) : m_value(std::forward<Args>(args)...) {
+        ++counts().constructions;
+    }
+    Traced(const Traced& other) : m_value(other.m_value) { ++counts().copies; }
+    Traced(Traced&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : m_value(std::move(other.m_value)) {
+        ++counts().moves;
+    }
+    Traced& operator=(const Traced& other) {
+        m_value = other.m_value;
+        ++counts().copy_assignments;
+        return *this;
+    }
+    Traced& operator=(Traced&& other) noexcept(
+        std::is_nothrow_move_assignable_v<T>) {
+        m_value = std::move(other.m_value);
+        ++counts().move_assignments;
+        return *this;
+    }
+    ~Traced() { ++counts().destructions; }
+
+    T& get() { return m_value; }
+    const T& get() const { return m_value; }
+    T& operator*() { return m_value; }
+    const T& operator*() const { return m_value; }
+    T* operator->() { return &m_value; }
+    const T* operator->() const { return &m_value; }
+
+    friend bool operator==(const Traced&, const Traced&) = default;
+    friend auto operator<=>(const Traced&, const Traced&) = default;
+
+   private:
+    static TraceCounts& counts() { return detail::trace_counts<T>(); }
+
+    T m_value;
+};
+
+}  // namespace benchmark
@@ -1,14 +1,30 @@
 #include <math.h>
 
+#include <cstdint>
+#include <format>
+#include <numbers>
 #include <print>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+#include "simd/reduce.hpp"
+#include "simd/sentinel.hpp"
+#include "tables/lookup_table.hpp"
+
 void print(auto&& v) { std::println("{}", v); }
 
 namespace capitulo_1 {
 constexpr double square(double x) { return x * x; }
 consteval double square2(double x) { return x * x; }
 
+// funções 'constexpr'/'consteval' também podem ser usadas para pré-calcular
+// dados: 'make_table' avalia o gerador em tempo de compilação e a tabela fica
+// em memória de apenas leitura. por 'square2' ser 'consteval', o gerador
+// também precisa ser (uma lambda 'consteval').
+constexpr auto squares =
+    tables::make_table<256>([](std::size_t i) consteval { return square2(i); });
+static_assert(squares[12] == 144.0);
+
 void print_square(double x) {
     std::println("The square of {} is {}", x, square(x));
 }
@@ -48,7 +64,10 @@ void fct(int arg) {    // fct possui escope global
                // sobreviverá até ser destruído por 'delete'.
 }
 
-double sum(const std::vector<double>& v) {
+// versão original: um único acumulador, em que cada soma depende do resultado
+// da anterior. o laço fica limitado pela latência da adição, e o compilador
+// não pode reordenar as somas para vetorizá-lo.
+double sum_serial(const std::vector<double>& v) {
     double res = 0;
     for (auto& i : v) {
         res += i;
@@ -56,6 +75,24 @@ double sum(const std::vector<double>& v) {
     return res;
 }
 
+// o motor de 'simd/reduce.hpp' escolhe em tempo de execução o conjunto de
+// instruções, usa vários acumuladores e, para vetores grandes, OpenMP.
+double sum(const std::vector<double>& v) { return simd::sum(v); }
+
+// o laço de 'main' que percorre 'pv' até o zero, sem as impressões: um elemento
+// e dois desvios por iteração. 'simd::count_until_sentinel' faz o mesmo com um
+// registrador inteiro por vez.
+int count_until_zero(const int* pv, int val) {
+    int count{0};
+    while (*pv) {
+        if (*pv == val) {
+            ++count;
+        }
+        ++pv;
+    }
+    return count;
+}
+
 void main() {
     std::println("{}", "Hello world!");
     print_square(1.234);
@@ -292,4 +329,104 @@ void main() {
         // int& r2;  // erro: toda referência precisa ser inicializada.
     }
 }
+
+// kernels registrados para o modo '--bench'. os dados de entrada são criados
+// uma única vez, fora da região cronometrada.
+void benchmarks() {
+    // de residente em L1 (16 KiB) até residente em DRAM (256 MiB).
+    for (int n : {1 << 11, 1 << 15, 1 << 19, 1 << 25}) {
+        auto v = benchmark::lazy([n] { return std::vector<double>(n, 1.1); });
+        benchmark::add(std::format("capitulo_1/sum/{}", n),
+                       [v] { benchmark::do_not_optimize(sum(v())); });
+        benchmark::add(std::format("capitulo_1/sum_serial/{}", n),
+                       [v] { benchmark::do_not_optimize(sum_serial(v())); });
+        // cada ISA suportado, em uma única thread.
+        for (auto isa : {simd::Isa::scalar, simd::Isa::sse2, simd::Isa::avx2,
+                         simd::Isa::avx512}) {
+            if (!simd::supported(isa)) {
+                continue;
+            }
+            benchmark::add(
+                std::format("capitulo_1/sum/{}/{}", simd::isa_name(isa), n),
+                [v, isa] {
+                    benchmark::do_not_optimize(
+                        simd::sum(v(), {simd::Summation::fast, isa, 0}));
+                });
+        }
+        for (auto mode : {simd::Summation::kahan, simd::Summation::pairwise}) {
+            auto name = mode == simd::Summation::kahan ? "kahan" : "pairwise";
+            benchmark::add(
+                std::format("capitulo_1/sum/{}/{}", name, n), [v, mode] {
+                    benchmark::do_not_optimize(simd::sum(
+                        v(), {mode, simd::best_isa(), 0}));
+                });
+        }
+    }
+    // fases quantizadas em 4096 passos: recalcular 'std::sin' a cada elemento
+    // contra uma leitura de 'tables::sin_table', gerada em compilação.
+    for (int n : {1 << 10, 1 << 16}) {
+        auto phases = benchmark::lazy([n] {
+            std::vector<std::uint16_t> v(n);
+            for (int i = 0; i < n; i++) {
+                v[i] = (i * 2654435761u) >> 20;  // 12 bits pseudoaleatórios
+            }
+            return v;
+        });
+        benchmark::add(std::format("capitulo_1/phase_sin/std_sin/{}", n),
+                       [phases] {
+                           double acc = 0;
+                           for (auto k : phases()) {
+                               acc += std::sin(2 * std::numbers::pi * k / 4096);
+                           }
+                           benchmark::do_not_optimize(acc);
+                       });
+        benchmark::add(std::format("capitulo_1/phase_sin/table/{}", n),
+                       [phases] {
+                           double acc = 0;
+                           for (auto k : phases()) {
+                               acc += tables::sin_table<4096>[k];
+                           }
+                           benchmark::do_not_optimize(acc);
+                       });
+    }
+    // buffers no estilo C terminados em zero, com valores de 1 a 4.
+    for (int n : {1 << 8, 1 << 14, 1 << 20}) {
+        auto make = [n]<typename T>(T) {
+            std::vector<T> v(n + 1);
+            for (int i = 0; i < n; i++) {
+                v[i] = i * 7 % 4 + 1;
+            }
+            v[n] = 0;
+            return v;
+        };
+        auto v32 = benchmark::lazy([make] { return make(std::int32_t{}); });
+        auto v64 = benchmark::lazy([make] { return make(std::int64_t{}); });
+        benchmark::add(std::format("capitulo_1/count_until_zero/{}", n),
+                       [v32] {
+                           benchmark::do_not_optimize(
+                               count_until_zero(v32().data(), 2));
+                       });
+        for (auto isa : {simd::Isa::scalar, simd::Isa::sse2, simd::Isa::avx2,
+                         simd::Isa::avx512}) {
+            if (!simd::supported(isa)) {
+                continue;
+            }
+            auto name = simd::isa_name(isa);
+            benchmark::add(
+                std::format("capitulo_1/count_until_sentinel/i32/{}/{}", name,
+                            n),
+                [v32, isa] {
+                    benchmark::do_not_optimize(simd::count_until_sentinel(
+                        v32().data(), 2, 0, isa));
+                });
+            benchmark::add(
+                std::format("capitulo_1/count_until_sentinel/i64/{}/{}", name,
+                            n),
+                [v64, isa] {
+                    benchmark::do_not_optimize(simd::count_until_sentinel(
+                        v64().data(), 2, 0, isa));
+                });
+        }
+    }
+}
 }  // namespace capitulo_1
@@ -17,6 +17,8 @@
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+
 template <typename T>
 concept Printable = requires(T t) { std::cout << t; };
 template <Printable... T>
@@ -204,4 +206,13 @@ void main() {
     use_regex_search();
     use_regex_match();
 };
+
+void benchmarks() {
+    benchmark::add("capitulo_10/compose", [] {
+        benchmark::do_not_optimize(compose("dmr", "bell-labs.com"));
+    });
+    benchmark::add("capitulo_10/cat", [] {
+        benchmark::do_not_optimize(cat("Edward", "Kennedy"));
+    });
+}
 }  // namespace capitulo_10
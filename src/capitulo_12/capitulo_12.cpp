@@ -26,6 +26,8 @@
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+
 template <typename T>
 concept Printable = requires(T t) { std::cout << t; };
 template <Printable... T>
@@ -324,4 +326,18 @@ void main() {
     // maior que 'c2'; '!=', '<', '<=' '>' e '>=' são automaticamente gerados à
     // partir de '<=>';
 };
+
+void benchmarks() {
+    // 'phone_book_2 = phone_book' de 'main': copia o vetor e cada 'string' que
+    // não cabe no 'small string buffer'.
+    benchmark::add("capitulo_12/phone_book_copy",
+                   [phone_book = vector<Entry>{
+                        {"David Hume", 012345},
+                        {"Karl Popper", 678910},
+                        {"Bertrand Arthur William Russel", 111213},
+                    }] {
+                       vector<Entry> phone_book_2 = phone_book;
+                       benchmark::do_not_optimize(phone_book_2.data());
+                   });
+}
 }  // namespace capitulo_12
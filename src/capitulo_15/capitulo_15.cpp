@@ -29,6 +29,8 @@
 #include <variant>
 #include <vector>
 
+#include "tables/perfect_hash.hpp"
+
 template <typename T>
 concept Printable = requires(T t) { std::cout << t; };
 template <Printable... T>
@@ -66,12 +68,14 @@ struct Entry {
 };
 
 enum class ErrorCode { range_error, length_error, found, not_found };
-std::unordered_map<ErrorCode, string> ErrorCodeMap = {
-    {ErrorCode::range_error, "range_error"},
-    {ErrorCode::length_error, "length_error"},
-    {ErrorCode::found, "found"},
-    {ErrorCode::not_found, "not_found"},
-};
+// tabela fixa: gerada em tempo de compilação (ver "tables/perfect_hash.hpp").
+constexpr auto ErrorCodeMap = tables::make_perfect_hash_map(
+    std::to_array<std::pair<ErrorCode, std::string_view>>({
+        {ErrorCode::range_error, "range_error"},
+        {ErrorCode::length_error, "length_error"},
+        {ErrorCode::found, "found"},
+        {ErrorCode::not_found, "not_found"},
+    }));
 
 // Pointer
 // de forma geral, um ponteiro nos permite acessa e manipular objetos, de acordo
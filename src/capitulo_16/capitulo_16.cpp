@@ -35,6 +35,8 @@
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+
 namespace capitulo_16 {
 using std::cerr;
 using std::cout;
@@ -902,4 +904,18 @@ void main() {
     // há a necessidade de se terminar um programa quando um erro muito grave
     // tenha ocorrido.
 };
+
+void benchmarks() {
+    // 'vs.push_back(s1)' de 'main' copia 's1'. uma 'string' curta ("Hello")
+    // cabe no 'small string buffer' e apenas o 'vector' aloca; uma longa
+    // também aloca na cópia.
+    for (int n : {5, 64}) {
+        benchmark::add(std::format("capitulo_16/push_back_copy/{}", n),
+                       [s1 = string(n, 'x')] {
+                           std::vector<string> vs;
+                           vs.push_back(s1);
+                           benchmark::do_not_optimize(vs.data());
+                       });
+    }
+}
 }  // namespace capitulo_16
@@ -47,6 +47,8 @@
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+
 namespace capitulo_18 {
 using std::cerr;
 using std::cout;
@@ -357,6 +359,35 @@ std::generator<int> fib() {
     }
 };
 
+// as acumulações das lambdas 'h' e 'i' de 'main', em forma de funções, para
+// que possam ser registradas como kernels em 'benchmarks()'.
+double accum(vector<double>::const_iterator begin,
+             vector<double>::const_iterator end, double init) {
+    return std::accumulate(begin, end, init);
+}
+
+double accum_packaged_task(const vector<double>& v) {
+    std::packaged_task pt0{accum};
+    std::packaged_task pt1{accum};
+    std::future<double> f0{pt0.get_future()};
+    std::future<double> f1{pt1.get_future()};
+    auto first = v.begin();
+    std::jthread t1{std::move(pt0), first, first + v.size() / 2, 0.0};
+    std::jthread t2{std::move(pt1), first + v.size() / 2, first + v.size(),
+                    0.0};
+    return f0.get() + f1.get();
+}
+
+double accum_async(const vector<double>& v) {
+    auto first = v.begin();
+    auto sz = v.size();
+    auto f0 = std::async(accum, first, first + sz * 1 / 4, 0.0);
+    auto f1 = std::async(accum, first + sz * 1 / 4, first + sz * 2 / 4, 0.0);
+    auto f2 = std::async(accum, first + sz * 2 / 4, first + sz * 3 / 4, 0.0);
+    auto f3 = std::async(accum, first + sz * 3 / 4, first + sz, 0.0);
+    return f0.get() + f1.get() + f2.get() + f3.get();
+}
+
 void main() {
     auto a = []() {
         int a{44};
@@ -665,4 +696,22 @@ void main() {
     };
     k();
 };
+
+void benchmarks() {
+    for (int n : {1 << 10, 1 << 20}) {
+        benchmark::add(format("capitulo_18/accumulate/{}", n),
+                       [v = vector<double>(n, 1.0)] {
+                           benchmark::do_not_optimize(
+                               accum(v.begin(), v.end(), 0.0));
+                       });
+        benchmark::add(format("capitulo_18/packaged_task/{}", n),
+                       [v = vector<double>(n, 1.0)] {
+                           benchmark::do_not_optimize(accum_packaged_task(v));
+                       });
+        benchmark::add(format("capitulo_18/async/{}", n),
+                       [v = vector<double>(n, 1.0)] {
+                           benchmark::do_not_optimize(accum_async(v));
+                       });
+    }
+}
 }  // namespace capitulo_18
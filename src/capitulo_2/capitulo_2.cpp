@@ -1,5 +1,15 @@
+#include <cstdint>
+#include <format>
 #include <print>
+#include <random>
+#include <span>
+#include <string>
 #include <variant>
+#include <vector>
+
+#include "benchmark/benchmark.hpp"
+#include "memory/allocation.hpp"
+#include "simd/state_machine.hpp"
 
 void print(auto&& v) { std::println("{}", v); }
 
@@ -9,17 +19,21 @@ struct Vector {
     int sz;        // número de elementos
 };
 
+// a política de alocação é escolhida em tempo de compilação; a padrão alinha
+// os elementos à linha de cache (ver "memory/allocation.hpp").
+template <memory::AllocationPolicy Allocation = memory::DefaultAllocation>
 void vector_init(Vector& v, int s) {
     if (s <= 0) {
         return;
     }
-    v.elem = new double[s];
+    v.elem = memory::new_array<double, Allocation>(s);
     v.sz = s;
 }
 
+template <memory::AllocationPolicy Allocation = memory::DefaultAllocation>
 double sum(int s) {
     Vector v;
-    vector_init(v, s);
+    vector_init<Allocation>(v, s);
 
     for (int i = 0; i < s; i++) {
         v.elem[i] = (i + 1) * 1.1;
@@ -28,6 +42,8 @@ double sum(int s) {
     for (int i = 0; i < s; i++) {
         sum += v.elem[i];
     }
+    // 'Vector' ainda não possui destructor (capítulo 5).
+    memory::delete_array<double, Allocation>(v.elem, s);
     return sum;
 }
 
@@ -38,10 +54,12 @@ void f(Vector v, Vector& rv, Vector* pv) {
     int i3 = pv->sz;  // acesso de membro por um ponteiro
 }
 
+template <memory::AllocationPolicy Allocation = memory::DefaultAllocation>
 class Vector_2 {
    public:
     Vector_2(int s)
-        : elem{new double[s]}, sz{s} {};  // construtor da classe Vector_2
+        : elem{memory::new_array<double, Allocation>(s)},
+          sz{s} {};  // construtor da classe Vector_2
     double& operator[](int i) {
         return elem[i];
     };  // acesso aos elementos pelo operador '[]'
@@ -67,7 +85,7 @@ double sum_2(int s) {
 
 enum class Color { red, blue, green };
 enum class TrafficLight { green, yellow, red };
-TrafficLight& operator++(TrafficLight& t) {
+constexpr TrafficLight& operator++(TrafficLight& t) {
     using enum TrafficLight;
     switch (t) {
         case green:
@@ -80,6 +98,19 @@ TrafficLight& operator++(TrafficLight& t) {
             return t = green;
             break;
     }
+    return t;
+}
+
+// a mesma transição, como tabela para avançar muitos semáforos de uma vez.
+constexpr auto traffic_light_next = simd::transitions<TrafficLight, 3>(
+    [](TrafficLight t) { return ++t; });
+static_assert(traffic_light_next[int(TrafficLight::red)] ==
+              int(TrafficLight::green));
+
+void step(std::vector<TrafficLight>& lights) {
+    for (auto& l : lights) {
+        ++l;  // um 'switch' por semáforo
+    }
 }
 
 enum class Type { ptr, num };
@@ -123,6 +154,97 @@ void f(Entry_3* pe) {
     }
 }
 
+// as três versões de 'Entry' guardam registros heterogêneos lado a lado, e
+// processá-los exige testar o tipo de cada elemento: com tipos misturados ao
+// acaso, o desvio é mal previsto em boa parte das vezes. 'EntryTable' guarda
+// os mesmos dados em colunas: nomes e tipos em arrays próprios, e os valores
+// particionados por alternativa, cada um num array homogêneo. operações em
+// massa sobre uma alternativa percorrem um array contíguo, sem nenhum desvio
+// por elemento, e podem ser vetorizadas pelo compilador.
+class EntryTable {
+   public:
+    void push_back(std::string name, Node* p) {
+        add_row(std::move(name), Type::ptr, ptr_index);
+        ptr_values.push_back(p);
+    }
+    void push_back(std::string name, int i) {
+        add_row(std::move(name), Type::num, num_index);
+        num_values.push_back(i);
+    }
+    void push_back(const Entry& e) {
+        if (e.t == Type::num) {
+            push_back(e.name, e.i);
+        } else {
+            push_back(e.name, e.p);
+        }
+    }
+
+    std::size_t size() const { return names.size(); }
+    const std::string& name(std::size_t row) const { return names[row]; }
+    Type type(std::size_t row) const { return types[row]; }
+    // acesso a um registro pela sua posição de inserção.
+    int num(std::size_t row) const { return num_values[slots[row]]; }
+    Node* ptr(std::size_t row) const { return ptr_values[slots[row]]; }
+
+    // colunas homogêneas: o k-ésimo valor pertence à linha 'num_rows()[k]'.
+    std::span<const int> nums() const { return num_values; }
+    std::span<Node* const> ptrs() const { return ptr_values; }
+    std::span<const std::uint32_t> num_rows() const { return num_index; }
+    std::span<const std::uint32_t> ptr_rows() const { return ptr_index; }
+
+   private:
+    void add_row(std::string name, Type t, std::vector<std::uint32_t>& rows) {
+        const auto row = static_cast<std::uint32_t>(names.size());
+        slots.push_back(static_cast<std::uint32_t>(rows.size()));
+        rows.push_back(row);
+        names.push_back(std::move(name));
+        types.push_back(t);
+    }
+
+    std::vector<std::string> names;
+    std::vector<Type> types;
+    std::vector<std::uint32_t> slots;  // posição da linha na sua coluna
+    std::vector<int> num_values;
+    std::vector<Node*> ptr_values;
+    std::vector<std::uint32_t> num_index;  // linhas de cada alternativa
+    std::vector<std::uint32_t> ptr_index;
+};
+
+// o equivalente de chamar 'f' para cada registro: sem teste de tipo.
+void f(const EntryTable& table) {
+    for (int i : table.nums()) {
+        print(i);
+    }
+}
+
+long long sum_nums(const std::vector<Entry>& entries) {
+    long long sum = 0;
+    for (const auto& e : entries) {
+        if (e.t == Type::num) {
+            sum += e.i;
+        }
+    }
+    return sum;
+}
+
+long long sum_nums(const std::vector<Entry_3>& entries) {
+    long long sum = 0;
+    for (const auto& e : entries) {
+        if (const int* i = std::get_if<int>(&e.v)) {
+            sum += *i;
+        }
+    }
+    return sum;
+}
+
+long long sum_nums(const EntryTable& table) {
+    long long sum = 0;
+    for (int i : table.nums()) {  // array contíguo: vetorizável
+        sum += i;
+    }
+    return sum;
+}
+
 void main() {
     print(sum(5));
     {
@@ -152,5 +274,108 @@ void main() {
         auto signal = TrafficLight::red;
         print(++signal == TrafficLight::green);
     }
+    {
+        Node node{1.5};
+        EntryTable table;
+        table.push_back("a", 1);
+        table.push_back("b", &node);
+        table.push_back(Entry{"c", Type::num, nullptr, 3});
+        f(table);  // 1 3
+        print(table.name(table.num_rows()[1]));  // c
+    }
+    {
+        simd::StateBatch<TrafficLight, 3> lights(1000, TrafficLight::green);
+        lights.step(traffic_light_next);
+        lights.step(traffic_light_next);
+        print(lights[999] == TrafficLight::red);
+    }
+}
+
+void benchmarks() {
+    for (int n : {1 << 10, 1 << 20}) {
+        benchmark::add(std::format("capitulo_2/sum/{}", n),
+                       [n] { benchmark::do_not_optimize(sum(n)); });
+    }
+    // com 's' grande, a varredura toca 256 MiB: com páginas de 4 KiB são
+    // 65536 entradas de TLB, com páginas de 2 MiB apenas 128. a diferença
+    // aparece na coluna 'dtlb_misses' de '--perf'.
+    constexpr int large = 1 << 25;
+    benchmark::add(std::format("capitulo_2/sum/new_delete/{}", large), [] {
+        benchmark::do_not_optimize(sum<memory::NewDelete>(large));
+    });
+    benchmark::add(std::format("capitulo_2/sum/aligned/{}", large), [] {
+        benchmark::do_not_optimize(sum<memory::Aligned<>>(large));
+    });
+    benchmark::add(std::format("capitulo_2/sum/huge_page/{}", large), [] {
+        benchmark::do_not_optimize(sum<memory::HugePage<>>(large));
+    });
+    benchmark::add(std::format("capitulo_2/sum/numa_local/{}", large), [] {
+        benchmark::do_not_optimize(sum<memory::Numa<>>(large));
+    });
+
+    for (int n : {1 << 12, 1 << 24}) {
+        auto lights = benchmark::lazy(
+            [n] { return std::vector<TrafficLight>(n, TrafficLight::green); });
+        benchmark::add(std::format("capitulo_2/traffic_light/switch/{}", n),
+                       [lights] {
+                           step(lights());
+                           benchmark::clobber_memory();
+                       });
+        for (auto isa : {simd::Isa::scalar, simd::Isa::sse2, simd::Isa::avx2,
+                         simd::Isa::avx512}) {
+            if (!simd::supported(isa)) {
+                continue;
+            }
+            auto batch = benchmark::lazy(
+                [n] { return simd::StateBatch<TrafficLight, 3>(n); });
+            benchmark::add(std::format("capitulo_2/traffic_light/{}/{}",
+                                       simd::isa_name(isa), n),
+                           [batch, isa] {
+                               batch().step(traffic_light_next, isa);
+                               benchmark::clobber_memory();
+                           });
+        }
+    }
+
+    // registros com tipos sorteados (metade de cada): o teste do tipo por
+    // elemento é imprevisível para o preditor de desvios.
+    struct Entries {
+        std::vector<Entry> aos;
+        std::vector<Entry_3> variants;
+        EntryTable table;
+    };
+    static Node node{1.0};
+    for (int n : {1 << 12, 1 << 20}) {
+        auto entries = benchmark::lazy([n] {
+            Entries e;
+            std::mt19937 gen{42};
+            for (int k = 0; k < n; k++) {
+                auto name = std::to_string(k);
+                if (gen() & 1) {
+                    e.aos.push_back({name, Type::num, nullptr, k});
+                    e.variants.push_back({name, k});
+                } else {
+                    e.aos.push_back({name, Type::ptr, &node, 0});
+                    e.variants.push_back({name, &node});
+                }
+                e.table.push_back(e.aos.back());
+            }
+            return e;
+        });
+        benchmark::add(std::format("capitulo_2/entries/tagged/{}", n),
+                       [entries] {
+                           benchmark::do_not_optimize(sum_nums(entries().aos));
+                       });
+        benchmark::add(std::format("capitulo_2/entries/variant/{}", n),
+                       [entries] {
+                           benchmark::do_not_optimize(
+                               sum_nums(entries().variants));
+                       });
+        benchmark::add(std::format("capitulo_2/entries/columnar/{}", n),
+                       [entries] {
+                           benchmark::do_not_optimize(
+                               sum_nums(entries().table));
+                       });
+    }
 }
 }  // namespace capitulo_2
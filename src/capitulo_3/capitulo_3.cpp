@@ -1,9 +1,19 @@
 #include <format>
 #include <print>
+#include <random>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+#include "benchmark/traced.hpp"
+#include "containers/cow_vector.hpp"
+#include "memory/allocation.hpp"
+#include "tables/perfect_hash.hpp"
+
 void print(auto&& v) { std::println("{}", v); }
 
 namespace capitulo_3 {
@@ -30,14 +40,42 @@ void test(std::vector<int> v,
                  // representada por referência.
 }
 
+// a mesma interface com 'cow_vector': a passagem por valor apenas compartilha
+// os elementos, e a cópia só acontece em 'v[1] = 99'.
+void test(containers::cow_vector<int> v, containers::cow_vector<int>& rv) {
+    v[1] = 99;
+    rv[2] = 66;
+}
+
+// chamados que só leem o argumento recebido por valor.
+long sum_by_value(std::vector<int> v) {
+    long s = 0;
+    for (int i : v) {
+        s += i;
+    }
+    return s;
+}
+
+long sum_by_value(containers::cow_vector<int> v) {
+    long s = 0;
+    // 'std::as_const': o 'begin()' não 'const' faria a cópia que se quer
+    // evitar, pois 'v' compartilha os elementos com o argumento.
+    for (int i : std::as_const(v)) {
+        s += i;
+    }
+    return s;
+}
+
 void print_num(int valor, int base = 10) {
     ;
 }  // argumento 'base' possui um valor default. quando não informado na chamada
    // da respectiva função, assume este valor como padrão.
+template <memory::AllocationPolicy Allocation = memory::DefaultAllocation>
 class Vector {
    public:
     Vector(int s)
-        : elem{new double[s]}, sz{s} {};  // construtor da classe Vector
+        : elem{memory::new_array<double, Allocation>(s)},
+          sz{s} {};  // construtor da classe Vector
     double& operator[](
         int i) {  // o retorno deste operador 'double&' é uma referência ao
                   // 'iésimo' valor da array. Evita-se desta forma realizar
@@ -84,6 +122,27 @@ struct Entry {
 
 Entry give_me_entry(std::string nome, int valor) { return {nome, valor}; }
 
+// para um conjunto fixo de chaves, o mapa pode ser gerado em tempo de
+// compilação: sem alocação, sem inicialização dinâmica e com uma única posição
+// consultada por busca (ver "tables/perfect_hash.hpp").
+constexpr auto days_in_month = tables::make_perfect_hash_map(
+    std::to_array<std::pair<std::string_view, int>>({
+        {"Janeiro", 31},
+        {"Fevereiro", 28},
+        {"Março", 31},
+        {"Abril", 30},
+        {"Maio", 31},
+        {"Junho", 30},
+        {"Julho", 31},
+        {"Agosto", 31},
+        {"Setembro", 30},
+        {"Outubro", 31},
+        {"Novembro", 30},
+        {"Dezembro", 31},
+    }));
+static_assert(days_in_month.at("Fevereiro") == 28);
+static_assert(!days_in_month.contains("Smarch"));
+
 class Box {
    public:
     Box() { print("Box default constructor"); };
@@ -135,6 +194,26 @@ Box get_me_a_box_5() {
     return std::forward<decltype(b)>(b);
 }
 
+// as mesmas situações com 'benchmark::Traced': em vez de imprimir, cada
+// operação é contada, e os totais podem ser consultados com 'trace_report()'
+// ou, por kernel, com '--bench --trace'.
+using TracedBox = benchmark::Traced<std::vector<double>>;
+
+TracedBox get_me_a_traced_box_1() {
+    TracedBox b(1024, 4.1);
+    return b;  // RVO: nenhuma cópia ou movimentação
+}
+
+TracedBox get_me_a_traced_box_2() {
+    static TracedBox b(1024, 4.2);
+    return b;  // cópia
+}
+
+TracedBox get_me_a_traced_box_4() {
+    TracedBox b(1024, 4.4);
+    return std::move(b);  // movimentação
+}
+
 void main() {
     std::vector<int> fib = {1, 2, 3, 5, 8, 13, 21};
     test(fib, fib);
@@ -147,6 +226,7 @@ void main() {
     for (auto& [chave, valor] : m) {
         print(std::format("mês: {}; dia: {}", chave, valor));
     }
+    print(std::format("dias em Abril: {}", days_in_month.at("Abril")));
     Box b{42};  // parameter initialized constructor
     print(b.x());
     Box c = {b};  // copy constructor
@@ -178,5 +258,94 @@ void main() {
     Box n;
     n = get_me_a_box_3();
     print(n.x());
+    print("===============");
+    {
+        benchmark::reset_traces();
+        TracedBox o = get_me_a_traced_box_1();
+        TracedBox p = get_me_a_traced_box_2();
+        TracedBox q = get_me_a_traced_box_4();
+    }
+    for (const auto& t : benchmark::trace_report()) {
+        print(std::format("{}: {} construções, {} cópias, {} movimentações",
+                          t.type, t.counts.constructions, t.counts.copies,
+                          t.counts.moves));
+    }
+}
+
+void benchmarks() {
+    for (int n : {1 << 10, 1 << 20}) {
+        benchmark::add(std::format("capitulo_3/sum/{}", n),
+                       [v = std::vector<int>(n, 1)] {
+                           benchmark::do_not_optimize(sum(v));
+                       });
+        // 'test' recebe 'v' por valor: com '--alloc', a cópia aparece como
+        // uma alocação de 'n * sizeof(int)' bytes por chamada.
+        benchmark::add(std::format("capitulo_3/test_by_value/{}", n),
+                       [fib = std::vector<int>(n, 1)]() mutable {
+                           test(fib, fib);
+                           benchmark::do_not_optimize(fib[2]);
+                       });
+        // com 'cow_vector', a cópia só acontece na escrita ('v[1] = 99'): o
+        // chamado que escreve uma vez paga o mesmo O(n), o que só lê não.
+        benchmark::add(std::format("capitulo_3/test_by_value/cow/{}", n),
+                       [fib = containers::cow_vector<int>(n, 1)]() mutable {
+                           test(fib, fib);
+                           benchmark::do_not_optimize(fib.get(2));
+                       });
+        benchmark::add(
+            std::format("capitulo_3/read_only_by_value/vector/{}", n),
+            [v = std::vector<int>(n, 1)] {
+                benchmark::do_not_optimize(sum_by_value(v));
+            });
+        benchmark::add(std::format("capitulo_3/read_only_by_value/cow/{}", n),
+                       [v = containers::cow_vector<int>(n, 1)] {
+                           benchmark::do_not_optimize(sum_by_value(v));
+                       });
+    }
+    // buscas de nomes de meses (com 1/4 de nomes inexistentes) no mapa gerado
+    // em tempo de compilação e num 'std::unordered_map' com os mesmos dados.
+    auto queries = benchmark::lazy([] {
+        std::vector<std::string> q;
+        std::mt19937 gen{42};
+        for (int i = 0; i < 1024; i++) {
+            auto month = days_in_month.begin() + gen() % days_in_month.size();
+            q.emplace_back(month->first);
+            if (i % 4 == 0) {
+                q.back().pop_back();
+            }
+        }
+        return q;
+    });
+    benchmark::add("capitulo_3/month_lookup/unordered_map", [queries] {
+        static const std::unordered_map<std::string, int> m(
+            days_in_month.begin(), days_in_month.end());
+        int total = 0;
+        for (const auto& q : queries()) {
+            if (auto it = m.find(q); it != m.end()) {
+                total += it->second;
+            }
+        }
+        benchmark::do_not_optimize(total);
+    });
+    benchmark::add("capitulo_3/month_lookup/perfect_hash", [queries] {
+        int total = 0;
+        for (const auto& q : queries()) {
+            if (const int* days = days_in_month.find(q)) {
+                total += *days;
+            }
+        }
+        benchmark::do_not_optimize(total);
+    });
+    // com '--trace', a coluna de cópias/movimentações por iteração mostra
+    // o efeito de cada forma de retorno.
+    benchmark::add("capitulo_3/traced_box/rvo", [] {
+        benchmark::do_not_optimize(get_me_a_traced_box_1()->data());
+    });
+    benchmark::add("capitulo_3/traced_box/static_copy", [] {
+        benchmark::do_not_optimize(get_me_a_traced_box_2()->data());
+    });
+    benchmark::add("capitulo_3/traced_box/std_move", [] {
+        benchmark::do_not_optimize(get_me_a_traced_box_4()->data());
+    });
 }
 }  // namespace capitulo_3
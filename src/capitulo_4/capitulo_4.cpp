@@ -1,21 +1,97 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <expected>
 #include <format>
+#include <iostream>
+#include <memory>
 #include <numeric>
+#include <ostream>
 #include <print>
+#include <random>
+#include <span>
 #include <stdexcept>
+#include <streambuf>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+#include "containers/unchecked.hpp"
+#include "diagnostics/fault_log.hpp"
+#include "memory/allocation.hpp"
+
 void print(auto&& v) { std::println("{}", v); }
 
 namespace capitulo_4 {
 
-enum class ErrorAction { ignore, throwing, terminating, logging };
+// 'counting', 'sampled' e 'deferred' permitem manter as verificações ligadas
+// em produção: numa sequência de falhas, 'logging' formata e escreve a cada
+// falha, enquanto estas apenas contam, escrevem 1 em cada 'error_sample_rate'
+// falhas, ou enfileiram um registro para uma thread em segundo plano.
+enum class ErrorAction {
+    ignore,
+    throwing,
+    terminating,
+    logging,
+    counting,
+    sampled,
+    deferred
+};
 constexpr ErrorAction default_error_action =
     ErrorAction::throwing;  // ação padrão de erro
-enum class ErrorCode { range_error, length_error };
-std::string error_code_name[]{"range error", "length error"};
+enum class ErrorCode { range_error, length_error, allocation_error };
+constexpr std::size_t error_code_count = 3;
+// 'string_view' em vez de 'std::string': a tabela é constante, sem alocação
+// nem inicialização dinâmica.
+constexpr std::string_view error_code_name[]{"range error", "length error",
+                                             "allocation error"};
+
+constexpr std::uint64_t error_sample_rate = 1000;
+using ErrorCounters = diagnostics::FaultCounters<ErrorCode, error_code_count>;
+using ErrorSampler =
+    diagnostics::FaultSampler<ErrorCode, error_code_count, error_sample_rate>;
+
+// 'streambuf' que descarta tudo o que recebe: a formatação acontece por
+// inteiro, só a escrita não.
+class NullBuffer : public std::streambuf {
+   protected:
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        return n;
+    }
+};
+
+inline std::ostream& null_stream() {
+    static NullBuffer buffer;
+    static std::ostream out{&buffer};
+    return out;
+}
+
+// destino das mensagens de 'sampled' e 'deferred' (nunca nulo): 'stderr',
+// como um log, ou 'null_stream()', para que os benchmarks meçam a formatação
+// sem a E/S.
+inline std::atomic<std::ostream*> error_stream{&std::cerr};
+
+inline void format_error(const diagnostics::FaultRecord& r) {
+    std::println(*error_stream.load(std::memory_order_relaxed),
+                 "expect() failures: {} {} (thread {}, {} ns)", r.code,
+                 error_code_name[r.code], r.thread, r.time_ns);
+}
+
+// espaço para algumas "tempestades" de falhas ('fault_storm') enquanto a
+// thread de formatação não as consome.
+constexpr std::size_t error_log_capacity = 1 << 14;
+
+// criado na primeira falha; a thread de formatação é encerrada, e a fila
+// esvaziada, na saída do programa.
+inline diagnostics::FaultLog& error_log() {
+    static diagnostics::FaultLog log{format_error, error_log_capacity};
+    return log;
+}
 
 // ao criar uma função centralizada para processamento de
 // exceções, evita-se de espalhar a lógica de tratamento de
@@ -38,8 +114,28 @@ constexpr void expert(C cond, ErrorCode x) {
             std::terminate();
         }
     }
+    if constexpr (action == ErrorAction::counting) {
+        if (!cond()) [[unlikely]] {
+            ErrorCounters::add(x);
+        }
+    }
+    if constexpr (action == ErrorAction::sampled) {
+        if (!cond()) [[unlikely]] {
+            if (ErrorSampler::sample(x)) {
+                std::println(*error_stream.load(std::memory_order_relaxed),
+                             "expect() failures: {} {} (1 em {})", int(x),
+                             error_code_name[int(x)], error_sample_rate);
+            }
+        }
+    }
+    if constexpr (action == ErrorAction::deferred) {
+        if (!cond()) [[unlikely]] {
+            error_log().push(std::uint32_t(x));
+        }
+    }
 }
 
+template <memory::AllocationPolicy Allocation = memory::DefaultAllocation>
 class Vector {
    public:
     Vector(int s, double valor = 0.0) {
@@ -52,12 +148,47 @@ class Vector {
         // verificações iniciais no construtor, para que o objeto Vector possa
         // ser utilizado em sua plenitude. O comando 'throw' transfere o
         // controle para um handler para exceções do tipo 'out_of_range'.
-        elem = new double[s];
+        elem = memory::new_array<double, Allocation>(s);
         sz = s;
         for (int i = 0; i < s; i++) {
             elem[i] = valor;
         }
     };
+    // alternativa sem exceções ao construtor: quando tamanhos inválidos são
+    // frequentes, lançar e capturar uma exceção a cada falha custa caro (o
+    // 'unwinding' percorre tabelas e aloca o objeto da exceção), enquanto o
+    // 'std::expected' é apenas um valor de retorno.
+    static std::expected<Vector, ErrorCode> try_create(
+        int s, double valor = 0.0) noexcept {
+        if (s <= 0) {
+            return std::unexpected{ErrorCode::length_error};
+        }
+        double* p;
+        try {  // 'bad_alloc' é raro: aqui a exceção não pesa
+            p = memory::new_array<double, Allocation>(s);
+        } catch (const std::bad_alloc&) {
+            return std::unexpected{ErrorCode::allocation_error};
+        }
+        for (int i = 0; i < s; i++) {
+            p[i] = valor;
+        }
+        return Vector{p, s};
+    }
+    // com o 'Vector' devolvido por valor (no 'std::expected'), ele precisa ser
+    // dono da memória: destrutor, cópia e 'move'.
+    Vector(const Vector& other)
+        : elem{memory::new_array<double, Allocation>(other.sz)}, sz{other.sz} {
+        std::copy(other.elem, other.elem + sz, elem);
+    }
+    Vector(Vector&& other) noexcept
+        : elem{std::exchange(other.elem, nullptr)},
+          sz{std::exchange(other.sz, 0)} {}
+    Vector& operator=(Vector other) noexcept {
+        std::swap(elem, other.elem);
+        std::swap(sz, other.sz);
+        return *this;
+    }
+    ~Vector() { memory::delete_array<double, Allocation>(elem, sz); }
     double& operator[](int i) {
         // if (!(0 < i && i < size())) {
         //     throw std::out_of_range("Vector::operator[]");
@@ -72,14 +203,24 @@ class Vector {
                                      ErrorCode::range_error);
         return elem[i];
     };
+    // verifica o intervalo inteiro uma única vez; os acessos pelo 'span'
+    // devolvido não são verificados.
+    std::span<double> view(int first, int count) {
+        expert([=, this] { return containers::in_bounds(first, count, sz); },
+               ErrorCode::range_error);
+        return {elem + first, static_cast<std::size_t>(count)};
+    }
+    std::span<double> view() { return {elem, static_cast<std::size_t>(sz)}; }
     int size() { return sz; };
 
    private:
+    Vector(double* p, int s) : elem{p}, sz{s} {}
+
     double* elem;
     int sz;
 };
 
-void f(Vector& v) {
+void f(Vector<>& v) {
     try {
         v[3] += 41;  // uma operação qualquer com o vetor, que pode acabar
                      // resultando em alguma exceção.
@@ -105,6 +246,17 @@ void test(int n) {
     print("função test: não ocorreu nenhuma exceção até aqui");
 }
 
+// o mesmo que 'test', sem exceções: o erro é parte do valor de retorno.
+void test_expected(int n) {
+    auto v = Vector<>::try_create(n);
+    if (!v) {
+        print(std::format("erro: {}", error_code_name[int(v.error())]));
+        return;
+    }
+    print(std::format("função test_expected: Vector de tamanho {}",
+                      v->size()));
+}
+
 void f(const char* p) {
     assert(p !=
            nullptr);  // a macro assert é apenas compilada no mode de compilação
@@ -135,7 +287,9 @@ void user(
                         // exceção, a função std::terminate() é imediatamente
                         // invocada para finalizar o programa.
     Vector v{sz};
-    std::iota(&v[0], &v[sz], 1.0);  // fill v com os valores 1,2,3,4,...
+    // std::iota(&v[0], &v[sz], 1.0);  // '&v[sz]' já falha na verificação, e
+    //                                 // cada '&v[i]' é verificado.
+    containers::iota(v.view(), 1.0);  // fill v com os valores 1,2,3,4,...
 }
 
 void main() {
@@ -144,6 +298,138 @@ void main() {
     print(v[3]);
     test(-3);
     test(3);
+    test_expected(-3);
+    test_expected(3);
     v[6];
+
+    // falhas apenas contadas: nenhuma E/S no caminho da verificação.
+    for (int i = 0; i < 10; i++) {
+        expert<ErrorAction::counting>([i] { return i % 3 != 0; },
+                                      ErrorCode::range_error);
+    }
+    auto counts = ErrorCounters::totals();
+    print(std::format("falhas contadas: {} {}", counts[0],
+                      error_code_name[0]));
+    expert<ErrorAction::deferred>([] { return false; },
+                                  ErrorCode::length_error);
+    error_log().flush();
+}
+
+// "tempestade" de falhas: 1 em cada 16 verificações falha. enquanto o kernel
+// é medido, as mensagens de 'sampled' e 'deferred' são formatadas em
+// 'null_stream()' (ver 'storm_fixture'); com 'deferred', os registros
+// descartados por fila cheia são relatados ao lado do tempo, para que não
+// pareçam ganho de velocidade.
+constexpr int storm_size = 1 << 16;
+
+template <ErrorAction action>
+void fault_storm() {
+    for (int i = 0; i < storm_size; i++) {
+        benchmark::do_not_optimize(i);
+        expert<action>([i] { return (i & 15) != 0; }, ErrorCode::range_error);
+    }
+    if constexpr (action == ErrorAction::deferred) {
+        benchmark::set_value("descartados (total)",
+                             double(error_log().dropped()));
+    }
+}
+
+// troca 'error_stream' por 'null_stream()' durante a medição, e o restaura no
+// fim; com 'deferred', antes espera a thread de formatação esvaziar a fila,
+// para que nenhum registro da medição chegue a 'stderr'.
+template <ErrorAction action>
+benchmark::Fixture storm_fixture() {
+    auto previous = std::make_shared<std::ostream*>(nullptr);
+    return {[previous] { *previous = error_stream.exchange(&null_stream()); },
+            [previous] {
+                if constexpr (action == ErrorAction::deferred) {
+                    error_log().flush();
+                }
+                error_stream.store(*previous);
+            }};
+}
+
+void benchmarks() {
+    // acesso com verificação por 'expert<ErrorAction::logging>'.
+    for (int n : {1 << 10, 1 << 20}) {
+        benchmark::add(std::format("capitulo_4/vector_access/{}", n),
+                       [v = Vector{n, 1.0}]() mutable {
+                           double s = 0;
+                           for (int i = 0; i < v.size(); i++) {
+                               s += v[i];
+                           }
+                           benchmark::do_not_optimize(s);
+                       });
+    }
+    // acesso verificado elemento a elemento, intervalo validado uma vez, e
+    // ponteiro cru.
+    for (int n : {1 << 10, 1 << 20}) {
+        benchmark::add(std::format("capitulo_4/iota/checked/{}", n),
+                       [v = Vector{n}]() mutable {
+                           for (int i = 0; i < v.size(); i++) {
+                               v[i] = 1.0 + i;
+                           }
+                           benchmark::do_not_optimize(v[0]);
+                       });
+        benchmark::add(std::format("capitulo_4/iota/view/{}", n),
+                       [v = Vector{n}]() mutable {
+                           containers::iota(v.view(0, v.size()), 1.0);
+                           benchmark::do_not_optimize(v[0]);
+                       });
+        benchmark::add(std::format("capitulo_4/iota/raw/{}", n),
+                       [v = std::vector<double>(n)]() mutable {
+                           double* p = v.data();
+                           for (int i = 0; i < int(v.size()); i++) {
+                               p[i] = 1.0 + i;
+                           }
+                           benchmark::do_not_optimize(p[0]);
+                       });
+    }
+    // construção com tamanhos inválidos (negativos) numa fração 'percent' das
+    // vezes: exceção capturada contra 'std::expected'.
+    for (int percent : {0, 1, 10, 25, 50}) {
+        std::vector<int> sizes(1024, 16);
+        std::fill_n(sizes.begin(), sizes.size() * percent / 100, -1);
+        std::ranges::shuffle(sizes, std::mt19937{42});
+        benchmark::add(
+            std::format("capitulo_4/create/exception/{}%", percent), [sizes] {
+                int failures = 0;
+                for (int s : sizes) {
+                    try {
+                        Vector v{s};
+                        benchmark::do_not_optimize(v[0]);
+                    } catch (const std::length_error&) {
+                        failures++;
+                    }
+                }
+                benchmark::do_not_optimize(failures);
+            });
+        benchmark::add(
+            std::format("capitulo_4/create/expected/{}%", percent), [sizes] {
+                int failures = 0;
+                for (int s : sizes) {
+                    if (auto v = Vector<>::try_create(s)) {
+                        benchmark::do_not_optimize((*v)[0]);
+                    } else {
+                        failures++;
+                    }
+                }
+                benchmark::do_not_optimize(failures);
+            });
+    }
+    // 'logging' fica de fora: escreveria milhares de linhas no relatório.
+    benchmark::add(std::format("capitulo_4/fault_storm/ignore/{}", storm_size),
+                   fault_storm<ErrorAction::ignore>);
+    benchmark::add(
+        std::format("capitulo_4/fault_storm/counting/{}", storm_size),
+        fault_storm<ErrorAction::counting>);
+    benchmark::add(
+        std::format("capitulo_4/fault_storm/sampled/{}", storm_size),
+        fault_storm<ErrorAction::sampled>,
+        storm_fixture<ErrorAction::sampled>());
+    benchmark::add(
+        std::format("capitulo_4/fault_storm/deferred/{}", storm_size),
+        fault_storm<ErrorAction::deferred>,
+        storm_fixture<ErrorAction::deferred>());
 }
 }  // namespace capitulo_4
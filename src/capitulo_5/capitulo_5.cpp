@@ -1,15 +1,27 @@
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <deque>
 #include <format>
 #include <iostream>
 #include <list>
+#include <memory>
 #include <numeric>
 #include <print>
+#include <random>
 #include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+#include "containers/unchecked.hpp"
+#include "memory/allocation.hpp"
+
 void print(auto&& v) { std::println("{}", v); }
 
 namespace capitulo_5 {
@@ -52,14 +64,29 @@ class complex {
     complex& operator/=(const complex&);
 };
 
+// multiplicação e divisão complexas de fato, e não componente a componente.
 inline complex& complex::operator*=(const complex& z) {
-    re *= z.re;
-    im *= z.im;
+    const double r = re * z.re - im * z.im;
+    im = re * z.im + im * z.re;
+    re = r;
     return *this;
 }
+// divisão de Smith: divide pelo maior entre |z.re| e |z.im|, em vez de
+// calcular z.re² + z.im², que pode estourar ou perder precisão.
 inline complex& complex::operator/=(const complex& z) {
-    re /= z.re;
-    im /= z.im;
+    if (std::abs(z.re) >= std::abs(z.im)) {
+        const double t = z.im / z.re;
+        const double den = z.re + z.im * t;
+        const double r = (re + im * t) / den;
+        im = (im - re * t) / den;
+        re = r;
+    } else {
+        const double t = z.re / z.im;
+        const double den = z.re * t + z.im;
+        const double r = (re * t + im) / den;
+        im = (im * t - re) / den;
+        re = r;
+    }
     return *this;
 }
 
@@ -76,7 +103,201 @@ bool operator==(complex a, complex b) {
     return a.real() == b.real() && a.imag() == b.imag();
 }
 bool operator!=(complex a, complex b) { return !(a == b); }
+complex conj(complex z) { return {z.real(), -z.imag()}; }
+double abs(complex z) { return std::hypot(z.real(), z.imag()); }
+
+// estrutura de arrays ("SoA") de números complexos: as partes reais e
+// imaginárias ficam em buffers separados, em vez de um array de 'complex'
+// ("AoS") com as duas partes intercaladas. cada operação é então um laço sobre
+// 'double' contíguos, sem embaralhar as partes entre os 'lanes' dos
+// registradores, e '#pragma omp simd' vetoriza o laço inteiro (inclusive os
+// desvios da divisão de Smith, convertidos em 'blends'). com milhões de
+// elementos, o limite passa a ser a banda de memória.
+//
+// '[]' e 'set' convertem de e para o 'complex' escalar.
+class ComplexArray {
+   public:
+    explicit ComplexArray(std::size_t n, complex z = {})
+        : m_re(n, z.real()), m_im(n, z.imag()) {}
+    ComplexArray(std::initializer_list<complex> list) {
+        m_re.reserve(list.size());
+        m_im.reserve(list.size());
+        for (const complex& z : list) {
+            m_re.push_back(z.real());
+            m_im.push_back(z.imag());
+        }
+    }
+
+    std::size_t size() const { return m_re.size(); }
+    complex operator[](std::size_t i) const { return {m_re[i], m_im[i]}; }
+    void set(std::size_t i, complex z) {
+        m_re[i] = z.real();
+        m_im[i] = z.imag();
+    }
+    std::span<double> real() { return m_re; }
+    std::span<double> imag() { return m_im; }
+    std::span<const double> real() const { return m_re; }
+    std::span<const double> imag() const { return m_im; }
+
+    // o operando pode ser o próprio '*this' ('a *= a', 'a.fma(a, b)'): não há
+    // '__restrict' entre os buffers de '*this' e os dos operandos, e cada
+    // iteração lê todos os seus valores antes de escrever. como só o mesmo
+    // índice pode coincidir, '#pragma omp simd' continua correto.
+    ComplexArray& operator+=(const ComplexArray& z) {
+        check(z);
+        double* re = m_re.data();
+        double* im = m_im.data();
+        const double* zr = z.m_re.data();
+        const double* zi = z.m_im.data();
+#pragma omp simd
+        for (std::size_t i = 0; i < size(); i++) {
+            re[i] += zr[i];
+            im[i] += zi[i];
+        }
+        return *this;
+    }
+    ComplexArray& operator-=(const ComplexArray& z) {
+        check(z);
+        double* re = m_re.data();
+        double* im = m_im.data();
+        const double* zr = z.m_re.data();
+        const double* zi = z.m_im.data();
+#pragma omp simd
+        for (std::size_t i = 0; i < size(); i++) {
+            re[i] -= zr[i];
+            im[i] -= zi[i];
+        }
+        return *this;
+    }
+    ComplexArray& operator*=(const ComplexArray& z) {
+        check(z);
+        double* re = m_re.data();
+        double* im = m_im.data();
+        const double* zr = z.m_re.data();
+        const double* zi = z.m_im.data();
+#pragma omp simd
+        for (std::size_t i = 0; i < size(); i++) {
+            const double a = re[i], b = im[i], c = zr[i], d = zi[i];
+            re[i] = a * c - b * d;
+            im[i] = a * d + b * c;
+        }
+        return *this;
+    }
+    ComplexArray& operator*=(complex z) {
+        double* __restrict re = m_re.data();
+        double* __restrict im = m_im.data();
+        const double zr = z.real();
+        const double zi = z.imag();
+#pragma omp simd
+        for (std::size_t i = 0; i < size(); i++) {
+            const double r = re[i] * zr - im[i] * zi;
+            im[i] = re[i] * zi + im[i] * zr;
+            re[i] = r;
+        }
+        return *this;
+    }
+    // Smith, como em 'complex::operator/=', mas sem desvios: os dois ramos são
+    // escolhidos por elemento.
+    ComplexArray& operator/=(const ComplexArray& z) {
+        check(z);
+        double* re = m_re.data();
+        double* im = m_im.data();
+        const double* zr = z.m_re.data();
+        const double* zi = z.m_im.data();
+#pragma omp simd
+        for (std::size_t i = 0; i < size(); i++) {
+            const bool real_major = std::abs(zr[i]) >= std::abs(zi[i]);
+            const double t = real_major ? zi[i] / zr[i] : zr[i] / zi[i];
+            const double den = real_major ? zr[i] + zi[i] * t
+                                          : zr[i] * t + zi[i];
+            const double r = real_major ? re[i] + im[i] * t
+                                        : re[i] * t + im[i];
+            const double j = real_major ? im[i] - re[i] * t
+                                        : im[i] * t - re[i];
+            const double inv = 1.0 / den;  // uma divisão em vez de duas
+            re[i] = r * inv;
+            im[i] = j * inv;
+        }
+        return *this;
+    }
+
+    // *this += a * b, numa única passagem pela memória.
+    ComplexArray& fma(const ComplexArray& a, const ComplexArray& b) {
+        check(a);
+        check(b);
+        double* re = m_re.data();
+        double* im = m_im.data();
+        const double* ar = a.m_re.data();
+        const double* ai = a.m_im.data();
+        const double* br = b.m_re.data();
+        const double* bi = b.m_im.data();
+#pragma omp simd
+        for (std::size_t i = 0; i < size(); i++) {
+            const double p = ar[i] * br[i] - ai[i] * bi[i];
+            const double q = ar[i] * bi[i] + ai[i] * br[i];
+            re[i] += p;
+            im[i] += q;
+        }
+        return *this;
+    }
+    ComplexArray& conj() {
+        double* __restrict im = m_im.data();
+#pragma omp simd
+        for (std::size_t i = 0; i < size(); i++) {
+            im[i] = -im[i];
+        }
+        return *this;
+    }
+    // sem 'std::hypot' (uma chamada por elemento). o 'sqrt(re² + im²)'
+    // ingênuo falha nos dois extremos: os quadrados estouram perto de 1e154
+    // (resultado 'inf') e se anulam perto de 1e-154 (toda a precisão perdida).
+    // com a escala pelo maior componente, 'max * sqrt(1 + (min / max)²)', não
+    // há estouro nem anulação, e as escolhas são seleções, sem desvios.
+    // 'min == max' cobre os dois componentes nulos ou infinitos, em que
+    // 'min / max' seria 'NaN'. o executável de benchmark é compilado com
+    // '-fno-math-errno', e o 'sqrt' vira uma instrução vetorial.
+    std::vector<double> abs() const {
+        std::vector<double> res(size());
+        double* __restrict out = res.data();
+        const double* __restrict re = m_re.data();
+        const double* __restrict im = m_im.data();
+#pragma omp simd
+        for (std::size_t i = 0; i < size(); i++) {
+            const double a = std::abs(re[i]);
+            const double b = std::abs(im[i]);
+            const double hi = a > b ? a : b;
+            const double lo = a > b ? b : a;
+            const double r = hi == lo ? 1.0 : lo / hi;
+            out[i] = hi * std::sqrt(1.0 + r * r);
+        }
+        return res;
+    }
+
+   private:
+    void check(const ComplexArray& other) const {
+        if (other.size() != size()) {
+            throw std::length_error("ComplexArray: tamanhos diferentes");
+        }
+    }
+
+    std::vector<double> m_re;
+    std::vector<double> m_im;
+};
+
+ComplexArray operator+(ComplexArray a, const ComplexArray& b) {
+    return a += b;
+}
+ComplexArray operator-(ComplexArray a, const ComplexArray& b) {
+    return a -= b;
+}
+ComplexArray operator*(ComplexArray a, const ComplexArray& b) {
+    return a *= b;
+}
+ComplexArray operator/(ComplexArray a, const ComplexArray& b) {
+    return a /= b;
+}
 
+template <memory::AllocationPolicy Allocation = memory::DefaultAllocation>
 class Vector {
    public:
     Vector() : elem{nullptr}, sz{0} {}
@@ -87,18 +308,19 @@ class Vector {
         if (s == 0) {
             throw std::length_error{"Vector constructor: zero size"};
         }
-        elem = new double[s];
+        elem = memory::new_array<double, Allocation>(s);
         sz = s;
         for (int i = 0; i < s; i++) {
             elem[i] = valor;
         }
     };
     Vector(std::initializer_list<double>&& list)
-        : elem{new double[list.size()]}, sz{static_cast<int>(list.size())} {
+        : elem{memory::new_array<double, Allocation>(list.size())},
+          sz{static_cast<int>(list.size())} {
         std::ranges::copy(list, elem);
     }
     ~Vector() {
-        delete[] elem;
+        memory::delete_array<double, Allocation>(elem, sz);
     }  // destructor: liberação do recurso previamento alocado
     double& operator[](int i) {
         if (!(0 <= i && i < size())) {
@@ -106,6 +328,14 @@ class Vector {
         }
         return elem[i];
     };
+    // intervalo verificado uma única vez; acesso sem verificação pelo 'span'.
+    std::span<double> view(int first, int count) {
+        if (!containers::in_bounds(first, count, sz)) {
+            throw std::out_of_range("Vector::view");
+        }
+        return {elem + first, static_cast<std::size_t>(count)};
+    }
+    std::span<double> view() { return {elem, static_cast<std::size_t>(sz)}; }
     int size() const { return sz; };
     void push_back(double d);
 
@@ -120,9 +350,38 @@ class Container {  // classe abstrata que decalra a interface a ser definida
     virtual double& operator[](int) = 0;
     virtual int size() const = 0;
     virtual ~Container() {};
+
+    // acesso em blocos contíguos: 'chunk(i)' é o i-ésimo de 'chunk_count()'
+    // blocos, na ordem dos elementos. quem consome paga uma chamada virtual
+    // por bloco, e não por elemento, e o laço dentro de cada bloco pode ser
+    // vetorizado.
+    virtual int chunk_count() const = 0;
+    virtual std::span<double> chunk(int i) = 0;
+
+    // visita todos os blocos em ordem, com 'f(std::span<double>)'. 'f' não
+    // passa por 'std::function': a chamada indireta é uma por bloco.
+    template <typename F>
+    void for_each_chunk(F&& f) {
+        visit_chunks({std::addressof(f), [](void* p, std::span<double> s) {
+                          (*static_cast<std::remove_reference_t<F>*>(p))(s);
+                      }});
+    }
+
+   protected:
+    struct ChunkVisitor {
+        void* f;
+        void (*call)(void*, std::span<double>);
+    };
+    // o padrão usa 'chunk(i)'; containers em que achar o i-ésimo bloco não é
+    // O(1) sobrescrevem este percurso.
+    virtual void visit_chunks(ChunkVisitor v) {
+        for (int i = 0, n = chunk_count(); i < n; i++) {
+            v.call(v.f, chunk(i));
+        }
+    }
 };
 
-class VectorContainer
+class VectorContainer final
     : public Container {  // classe concreta, derivada da classe abstrata
                           // 'Container', que define a interface requisitada
    public:
@@ -135,17 +394,26 @@ class VectorContainer
        // do método e permite que o compilador possa detectar determinados
        // erros, tais como de tipografia, definição, tipos, etc.
     int size() const override { return v.size(); }
+    // um único bloco: o 'Vector' inteiro, verificado uma vez.
+    int chunk_count() const override { return 1; }
+    std::span<double> chunk(int i) override {
+        if (i != 0) {
+            throw std::out_of_range("VectorContainer::chunk");
+        }
+        return v.view();
+    }
 
    private:
-    Vector v;
+    Vector<> v;
 };
 
-class ListContainer
+class ListContainer final
     : public Container {  // Outros tipos de containers, desde que obedecendo a
                           // interface requisitada, podem ser definidos e
                           // utilizados sem problemas.
    public:
     ListContainer() {}
+    ListContainer(int s) : ld(s) {}
     ListContainer(std::initializer_list<double> list) : ld{list} {}
     ~ListContainer() {}
 
@@ -159,12 +427,230 @@ class ListContainer
         throw std::out_of_range("ListContainer");
     }
     int size() const override { return ld.size(); }
+    // cada nó da lista guarda um único elemento: blocos de tamanho 1.
+    int chunk_count() const override { return ld.size(); }
+    std::span<double> chunk(int i) override { return {&(*this)[i], 1}; }
     auto give_me_address() const { return std::addressof(ld); }
 
+   protected:
+    // percurso linear, em vez de 'chunk(i)' (O(i)) para cada bloco.
+    void visit_chunks(ChunkVisitor v) override {
+        for (double& x : ld) {
+            v.call(v.f, {&x, 1});
+        }
+    }
+
    private:
     std::list<double> ld;
 };
 
+// lista ligada "desenrolada": cada nó ocupa uma linha de cache e guarda vários
+// elementos contíguos, em vez de um por nó como 'std::list'. a inserção no
+// meio desloca apenas os elementos de um nó (e divide o nó cheio em dois), sem
+// mover os demais nós. um cursor guarda o último nó acessado e o índice do seu
+// primeiro elemento, de forma que o acesso sequencial por 'operator[]', como
+// em 'use', é O(1) amortizado: no máximo um passo de nó por chamada.
+class UnrolledListContainer final : public Container {
+   public:
+    UnrolledListContainer() {}
+    UnrolledListContainer(int s) {
+        for (int i = 0; i < s; i++) {
+            push_back(0.0);
+        }
+    }
+    UnrolledListContainer(std::initializer_list<double> list) {
+        for (double d : list) {
+            push_back(d);
+        }
+    }
+    UnrolledListContainer(const UnrolledListContainer&) = delete;
+    UnrolledListContainer& operator=(const UnrolledListContainer&) = delete;
+    ~UnrolledListContainer() {
+        while (head) {
+            delete std::exchange(head, head->next);
+        }
+    }
+
+    double& operator[](int i) override {
+        if (!(0 <= i && i < size())) {
+            throw std::out_of_range("UnrolledListContainer");
+        }
+        seek(i);
+        return cursor->values[i - cursor_first];
+    }
+    int size() const override { return sz; }
+    int chunk_count() const override { return nodes; }
+    std::span<double> chunk(int i) override {
+        if (!(0 <= i && i < nodes)) {
+            throw std::out_of_range("UnrolledListContainer::chunk");
+        }
+        seek_node(i);
+        return {cursor->values, static_cast<std::size_t>(cursor->count)};
+    }
+
+    void push_back(double d) { insert(sz, d); }
+    // insere 'd' na posição 'i' (0 <= i <= size()).
+    void insert(int i, double d) {
+        if (!(0 <= i && i <= sz)) {
+            throw std::out_of_range("UnrolledListContainer::insert");
+        }
+        if (!head) {
+            head = tail = new Node;
+            nodes = 1;
+            reset_cursor();
+        }
+        if (i == sz) {  // no fim: o último nó, sem percorrer a lista
+            cursor = tail;
+            cursor_first = sz - tail->count;
+            cursor_index = nodes - 1;
+        } else {
+            seek(i);
+        }
+        if (cursor->count == node_capacity && i == sz) {
+            // no fim, um nó novo e vazio: 'push_back' deixa os nós cheios.
+            split(cursor->count);
+            cursor_first += cursor->count;
+            cursor_index++;
+            cursor = cursor->next;
+        } else if (cursor->count == node_capacity) {
+            split(cursor->count / 2);
+            if (i - cursor_first > cursor->count) {
+                cursor_first += cursor->count;
+                cursor_index++;
+                cursor = cursor->next;
+            }
+        }
+        const int k = i - cursor_first;
+        std::copy_backward(cursor->values + k, cursor->values + cursor->count,
+                           cursor->values + cursor->count + 1);
+        cursor->values[k] = d;
+        cursor->count++;
+        sz++;
+    }
+
+   protected:
+    void visit_chunks(ChunkVisitor v) override {
+        for (Node* n = head; n; n = n->next) {
+            v.call(v.f, {n->values, static_cast<std::size_t>(n->count)});
+        }
+    }
+
+   private:
+    static constexpr std::size_t cache_line = 64;
+    static constexpr int node_capacity =
+        (cache_line - 2 * sizeof(void*) - sizeof(int)) / sizeof(double);
+
+    struct alignas(cache_line) Node {
+        Node* next{nullptr};
+        Node* prev{nullptr};
+        int count{0};
+        double values[node_capacity];
+    };
+    static_assert(sizeof(Node) == cache_line);
+
+    void reset_cursor() {
+        cursor = head;
+        cursor_first = 0;
+        cursor_index = 0;
+    }
+
+    // leva o cursor ao nó que contém o elemento 'i': parte do cursor, ou do
+    // início se ele estiver mais perto.
+    void seek(int i) {
+        if (i < cursor_first - i) {
+            reset_cursor();
+        }
+        while (i >= cursor_first + cursor->count) {
+            cursor_first += cursor->count;
+            cursor = cursor->next;
+            cursor_index++;
+        }
+        while (i < cursor_first) {
+            cursor = cursor->prev;
+            cursor_first -= cursor->count;
+            cursor_index--;
+        }
+    }
+    void seek_node(int index) {
+        if (index < cursor_index - index) {
+            reset_cursor();
+        }
+        for (; cursor_index < index; cursor_index++) {
+            cursor_first += cursor->count;
+            cursor = cursor->next;
+        }
+        for (; cursor_index > index; cursor_index--) {
+            cursor = cursor->prev;
+            cursor_first -= cursor->count;
+        }
+    }
+
+    // divide o nó do cursor, cheio, levando os elementos a partir de 'half'
+    // para um novo nó logo após ele. o cursor continua no mesmo nó.
+    void split(int half) {
+        Node* n = new Node;
+        n->count = cursor->count - half;
+        std::copy(cursor->values + half, cursor->values + cursor->count,
+                  n->values);
+        cursor->count = half;
+        n->prev = cursor;
+        n->next = cursor->next;
+        if (cursor->next) {
+            cursor->next->prev = n;
+        } else {
+            tail = n;
+        }
+        cursor->next = n;
+        nodes++;
+    }
+
+    Node* head{nullptr};
+    Node* tail{nullptr};
+    Node* cursor{nullptr};
+    int cursor_first{0};  // índice do primeiro elemento do nó do cursor
+    int cursor_index{0};  // posição do nó do cursor na lista
+    int sz{0};
+    int nodes{0};
+};
+
+// alternativa estática a 'Container' quando o conjunto de containers é
+// fechado: o tipo concreto fica num 'std::variant', e não atrás de um ponteiro
+// para a classe base. 'visit' resolve o tipo uma única vez e entrega o
+// container concreto a 'f', que faz o laço inteiro; como as classes são
+// 'final', cada chamada dentro do laço é direta e pode ser expandida 'inline'
+// (o laço é instanciado uma vez para cada alternativa). não há necessidade de
+// 'dynamic_cast' para descobrir o tipo.
+class StaticContainer {
+   public:
+    using Variant =
+        std::variant<VectorContainer, ListContainer, UnrolledListContainer>;
+
+    template <typename C, typename... Args>
+    explicit StaticContainer(std::in_place_type_t<C> type, Args&&... args)
+        : c{type, std::forward<Args>(args)...} {}
+
+    template <typename F>
+    decltype(auto) visit(F&& f) {
+        return std::visit(std::forward<F>(f), c);
+    }
+    template <typename C>
+    C* get_if() {
+        return std::get_if<C>(&c);
+    }
+
+    // acesso individual: um 'std::visit' (um salto por tabela) por chamada,
+    // como a chamada virtual. para laços, prefira 'visit'.
+    double& operator[](int i) {
+        return std::visit([i](auto& x) -> double& { return x[i]; }, c);
+    }
+    int size() const {
+        return std::visit([](const auto& x) { return x.size(); }, c);
+    }
+
+   private:
+    Variant c;
+};
+
 void use(Container& c) {
     const int sz = c.size();
     for (int i = 0; i < sz; i++) {
@@ -189,6 +675,20 @@ void main() {
     if (c != b) {
         c = -(b / a) + 2 * b;
     };
+    ComplexArray zs{{1, 2}, {3, -1}, z};
+    zs *= ComplexArray(zs.size(), complex{0, 1});  // rotação de 90 graus
+    zs.conj();
+    print(std::format("{} {}", zs[1].real(), zs[1].imag()));
+    // o operando pode ser o próprio array: 'sq *= sq' eleva ao quadrado, e
+    // 'sq.fma(sq, sq)' soma o quadrado (agora z^4) a si mesmo.
+    ComplexArray sq = zs;
+    sq *= sq;
+    sq.fma(sq, sq);
+    for (std::size_t i = 0; i < zs.size(); i++) {
+        const complex z2 = zs[i] * zs[i];
+        const complex expected = z2 + z2 * z2;
+        assert(abs(sq[i] - expected) <= 1e-12 * abs(expected));
+    }
 
     Vector v{1, 2.4, 3, 4};
     print(v.size());
@@ -197,6 +697,9 @@ void main() {
     use(vc);
     ListContainer lc{1, 24, 42, 3.33};
     use(lc);
+    UnrolledListContainer ulc{1, 24, 42, 3.33};
+    ulc.insert(2, 7.5);
+    use(ulc);
 
     // Container* con = &lc;
     Container* con = &vc;
@@ -206,5 +709,234 @@ void main() {
         std::cout << "List container with addres: " << p->give_me_address()
                   << std::endl;
     }
+
+    // o mesmo, sem 'dynamic_cast': o tipo é conhecido em cada instância.
+    StaticContainer sc{std::in_place_type<ListContainer>,
+                       std::initializer_list<double>{1, 24, 42, 3.33}};
+    sc.visit([](auto& x) {
+        using C = std::remove_cvref_t<decltype(x)>;
+        if constexpr (std::is_same_v<C, ListContainer>) {
+            std::cout << "List container with addres: "
+                      << x.give_me_address() << std::endl;
+        } else {
+            print(std::format("container de {} elementos", x.size()));
+        }
+    });
+}
+
+// mesmo percurso de 'use', mas acumulando em vez de imprimir.
+double sum(Container& c) {
+    double s = 0;
+    const int sz = c.size();
+    for (int i = 0; i < sz; i++) {
+        s += c[i];
+    }
+    return s;
+}
+
+// o mesmo, por blocos: uma chamada virtual por bloco.
+double sum_chunked(Container& c) {
+    double s = 0;
+    c.for_each_chunk([&s](std::span<double> chunk) {
+        s += containers::sum(chunk);
+    });
+    return s;
+}
+
+// percurso de 'sum', instanciado para cada container concreto.
+template <typename C>
+double sum_concrete(C& c) {
+    double s = 0;
+    const int sz = c.size();
+    for (int i = 0; i < sz; i++) {
+        s += c[i];
+    }
+    return s;
+}
+
+double sum(StaticContainer& c) {
+    return c.visit([](auto& x) { return sum_concrete(x); });
+}
+
+// acessos em ordem arbitrária ('idx'), para o caso em que o laço não pode ser
+// trocado por um percurso em blocos.
+double gather(Container& c, const std::vector<int>& idx) {
+    double s = 0;
+    for (int i : idx) {
+        s += c[i];
+    }
+    return s;
+}
+
+double gather(StaticContainer& c, const std::vector<int>& idx) {
+    return c.visit([&idx](auto& x) {
+        double s = 0;
+        for (int i : idx) {
+            s += x[i];
+        }
+        return s;
+    });
+}
+
+// os mesmos 'mixed_count' containers, 'VectorContainer' e
+// 'UnrolledListContainer' alternados, com 'n' elementos ao todo, atrás de
+// 'Container' e como 'StaticContainer'. ('ListContainer', com o acesso por
+// índice em O(n), dominaria o tempo.)
+constexpr int mixed_count = 16;
+
+// 'std::deque', pois 'StaticContainer' não pode ser movido.
+std::pair<std::vector<std::unique_ptr<Container>>,
+          std::deque<StaticContainer>>
+mixed_containers(int n) {
+    std::vector<std::unique_ptr<Container>> dynamic;
+    std::deque<StaticContainer> variants;
+    const int m = n / mixed_count;
+    for (int k = 0; k < mixed_count; k++) {
+        if (k % 2 == 0) {
+            dynamic.push_back(std::make_unique<VectorContainer>(m));
+            variants.emplace_back(std::in_place_type<VectorContainer>, m);
+        } else {
+            dynamic.push_back(std::make_unique<UnrolledListContainer>(m));
+            variants.emplace_back(std::in_place_type<UnrolledListContainer>,
+                                  m);
+        }
+    }
+    return {std::move(dynamic), std::move(variants)};
+}
+
+void benchmarks() {
+    for (int n : {1 << 10, 1 << 20}) {
+        benchmark::add(std::format("capitulo_5/complex_mul_add/{}", n),
+                       [zs = std::vector<complex>(n, complex{1.0, 0.5})] {
+                           complex acc{};
+                           for (const auto& z : zs) {
+                               acc += z * complex{0.99, 0.01};
+                           }
+                           benchmark::do_not_optimize(acc);
+                       });
+    }
+    // AoS ('std::vector<complex>') contra SoA ('ComplexArray'), a mesma
+    // operação elemento a elemento 'a[i] op= b[i]' sobre os mesmos dados: dois
+    // arrays lidos e um escrito nos dois lados. |b[i]| = 1, para que as
+    // repetições não levem os valores a 'inf' ou a subnormais.
+    for (int n : {1 << 10, 1 << 22}) {
+        auto aos = benchmark::lazy([n] {
+            return std::pair{std::vector<complex>(n, complex{1.0, 0.5}),
+                             std::vector<complex>(n, complex{0.6, 0.8})};
+        });
+        auto soa = benchmark::lazy([n] {
+            return std::pair{ComplexArray(n, complex{1.0, 0.5}),
+                             ComplexArray(n, complex{0.6, 0.8})};
+        });
+        benchmark::add(std::format("capitulo_5/complex_aos/mul/{}", n),
+                       [aos] {
+                           auto& [a, b] = aos();
+                           for (std::size_t i = 0; i < a.size(); i++) {
+                               a[i] *= b[i];
+                           }
+                           benchmark::do_not_optimize(a[0]);
+                       });
+        benchmark::add(std::format("capitulo_5/complex_array/mul/{}", n),
+                       [soa] {
+                           auto& [a, b] = soa();
+                           a *= b;
+                           benchmark::do_not_optimize(a.real()[0]);
+                       });
+        benchmark::add(std::format("capitulo_5/complex_aos/div/{}", n),
+                       [aos] {
+                           auto& [a, b] = aos();
+                           for (std::size_t i = 0; i < a.size(); i++) {
+                               a[i] /= b[i];
+                           }
+                           benchmark::do_not_optimize(a[0]);
+                       });
+        benchmark::add(std::format("capitulo_5/complex_array/div/{}", n),
+                       [soa] {
+                           auto& [a, b] = soa();
+                           a /= b;
+                           benchmark::do_not_optimize(a.real()[0]);
+                       });
+        benchmark::add(std::format("capitulo_5/complex_array/fma/{}", n),
+                       [soa] {
+                           auto& [a, b] = soa();
+                           a.fma(b, b);
+                           benchmark::do_not_optimize(a.real()[0]);
+                       });
+    }
+    // 'Container' virtual contra 'StaticContainer' (um único 'visit'). para
+    // um único tipo, a referência virtual é 'VectorContainer/index' e
+    // 'UnrolledListContainer/index', abaixo. 'mixed' é o caso em que o tipo
+    // só é conhecido em tempo de execução: 'mixed_count' containers de tipos
+    // alternados, percorridos por 'Container&' ou por 'visit'.
+    for (int n : {256, 4096}) {
+        std::vector<int> idx(4096);
+        std::mt19937 gen{42};
+        for (int& i : idx) {
+            i = std::uniform_int_distribution<int>{0, n - 1}(gen);
+        }
+        auto vc = std::make_shared<VectorContainer>(n);
+        auto svc = std::make_shared<StaticContainer>(
+            std::in_place_type<VectorContainer>, n);
+        auto suc = std::make_shared<StaticContainer>(
+            std::in_place_type<UnrolledListContainer>, n);
+        benchmark::add(std::format("capitulo_5/dispatch/static/vector/{}", n),
+                       [svc] { benchmark::do_not_optimize(sum(*svc)); });
+        benchmark::add(
+            std::format("capitulo_5/dispatch/virtual/vector_gather/{}", n),
+            [vc, idx] { benchmark::do_not_optimize(gather(*vc, idx)); });
+        benchmark::add(
+            std::format("capitulo_5/dispatch/static/vector_gather/{}", n),
+            [svc, idx] { benchmark::do_not_optimize(gather(*svc, idx)); });
+        benchmark::add(std::format("capitulo_5/dispatch/static/unrolled/{}", n),
+                       [suc] { benchmark::do_not_optimize(sum(*suc)); });
+        auto mixed = benchmark::lazy([n] { return mixed_containers(n); });
+        benchmark::add(std::format("capitulo_5/dispatch/virtual/mixed/{}", n),
+                       [mixed] {
+                           double s = 0;
+                           for (auto& c : mixed().first) {
+                               s += sum(*c);
+                           }
+                           benchmark::do_not_optimize(s);
+                       });
+        benchmark::add(std::format("capitulo_5/dispatch/static/mixed/{}", n),
+                       [mixed] {
+                           double s = 0;
+                           for (auto& c : mixed().second) {
+                               s += sum(c);
+                           }
+                           benchmark::do_not_optimize(s);
+                       });
+    }
+    // com '--perf', a diferença de 'l1d_misses'/'llc_misses' entre os dois
+    // containers aparece diretamente, em vez de ser inferida pelo tempo.
+    for (int n : {256, 4096}) {
+        benchmark::add(std::format("capitulo_5/VectorContainer/index/{}", n),
+                       [c = std::make_shared<VectorContainer>(n)] {
+                           benchmark::do_not_optimize(sum(*c));
+                       });
+        benchmark::add(std::format("capitulo_5/ListContainer/index/{}", n),
+                       [c = std::make_shared<ListContainer>(n)] {
+                           benchmark::do_not_optimize(sum(*c));
+                       });
+        benchmark::add(
+            std::format("capitulo_5/UnrolledListContainer/index/{}", n),
+            [c = std::make_shared<UnrolledListContainer>(n)] {
+                benchmark::do_not_optimize(sum(*c));
+            });
+        benchmark::add(
+            std::format("capitulo_5/VectorContainer/chunked/{}", n),
+            [c = std::make_shared<VectorContainer>(n)] {
+                benchmark::do_not_optimize(sum_chunked(*c));
+            });
+        benchmark::add(std::format("capitulo_5/ListContainer/chunked/{}", n),
+                       [c = std::make_shared<ListContainer>(n)] {
+                           benchmark::do_not_optimize(sum_chunked(*c));
+                       });
+        benchmark::add(
+            std::format("capitulo_5/UnrolledListContainer/chunked/{}", n),
+            [c = std::make_shared<UnrolledListContainer>(n)] {
+                benchmark::do_not_optimize(sum_chunked(*c));
+            });
+    }
 }
 }  // namespace capitulo_5
@@ -1,15 +1,29 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <compare>
+#include <concepts>
+#include <functional>
 #include <format>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <numeric>
 #include <print>
 #include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+#include "containers/unchecked.hpp"
+#include "memory/allocation.hpp"
+#include "simd/compare.hpp"
+
 void print(auto&& v, std::string s = "{}") { std::println(s, v); }
 
 namespace capitulo_6 {
@@ -89,38 +103,76 @@ bool operator==(complex a, complex b) {
 }
 bool operator!=(complex a, complex b) { return !(a == b); }
 
+// nós de uma expressão de 'Vector' ('a + b * c', ...), ver abaixo de 'Vector'.
+template <typename E>
+concept Expression = E::is_expression && requires(const E& e, int i) {
+    { e.size() } -> std::same_as<int>;
+    { e[i] } -> std::convertible_to<double>;
+};
+
+// buffer interno do 'Vector'; sem elementos, é uma classe vazia (ao contrário
+// de 'std::array<double, 0>' na libstdc++), que '[[no_unique_address]]' faz
+// não ocupar espaço.
+template <int N>
+struct InlineBuffer {
+    double values[N];
+    double* data() { return values; }
+    const double* data() const { return values; }
+};
+template <>
+struct InlineBuffer<0> {
+    double* data() { return nullptr; }
+    const double* data() const { return nullptr; }
+};
+
+// com 'InlineCapacity' > 0, vetores de até 'InlineCapacity' elementos ficam
+// num buffer dentro do próprio objeto ("small buffer optimization"): criar e
+// destruir um vetor curto não passa pelo alocador. 'elem' aponta para o buffer
+// interno ou para a memória de 'Allocation'; um vetor que cresce além do
+// buffer passa para a memória alocada. com 'InlineCapacity' == 0 (o padrão),
+// o buffer não ocupa espaço algum.
+template <memory::AllocationPolicy Allocation = memory::DefaultAllocation,
+          int InlineCapacity = 0>
 class Vector {
+    static_assert(InlineCapacity >= 0);
+
    public:
-    Vector() : elem{nullptr}, sz{0} {}
+    Vector() { reset(); }
     Vector(int s,
            double valor = 0.0) {  // construtor: responsável pela alocação dos
-                                  // rescusos (new double[]).
+                                  // rescusos ('Allocation').
         if (s < 0) {
             throw std::length_error{"Vector constructor: negative size"};
         }
         if (s == 0) {
             throw std::length_error{"Vector constructor: zero size"};
         }
-        elem = new double[s];
+        elem = allocate(s);
         sz = s;
+        cap = capacity_for(s);
         for (int i = 0; i < s; i++) {
             elem[i] = valor;
         }
     };
     Vector(std::initializer_list<double>&& list)
-        : elem{new double[list.size()]}, sz{static_cast<int>(list.size())} {
+        : elem{allocate(list.size())},
+          sz{static_cast<int>(list.size())},
+          cap{capacity_for(sz)} {
         std::ranges::copy(list, elem);
     }
     // deve-se implementar copy constructors e copy assignment constructors em
     // específico quando a classe é responsável por gerenciar recursos externos
     // (ponteiros, objetos alocados na heap, etc.)
-    Vector(const Vector& other) : elem{new double[other.sz]}, sz{other.sz} {
+    Vector(const Vector& other)
+        : elem{allocate(other.sz)}, sz{other.sz}, cap{capacity_for(sz)} {
         for (int i = 0; i < sz; i++) {
             elem[i] = other.elem[i];
         }
     }
     Vector& operator=(const Vector& other) {
-        double* p = new double[other.sz];
+        // com os dois no buffer interno, 'p == elem': a cópia é feita sobre
+        // ele, e não há o que liberar.
+        double* p = allocate(other.sz);
         for (int i = 0; i < other.sz; i++) {
             p[i] = other.elem[i];
         }
@@ -128,11 +180,15 @@ class Vector {
         // remoção (delete) para caso ocorra algum problema ou alguma exceção
         // seja levantada, o Vector original continua ainda retendo o recurso
         // original.
-        delete[] elem;  // deletar o recurso alocado previamente para evitar
-                        // vazamento de memória.
+        // deletar o recurso alocado previamente para evitar vazamento de
+        // memória.
+        if (p != elem) {
+            release();
+        }
         // por fim, realiza-se a atualização dos recursos internos.
         elem = p;
         sz = other.sz;
+        cap = capacity_for(other.sz);
         return *this;
     }
     // Para evitar processos custosos de cópia em operações com vetores, deve-se
@@ -140,22 +196,36 @@ class Vector {
     // assignment'.
     Vector(Vector&& other)
         : elem{other.elem},
-          sz{other.sz} {  // elem{other.elem} faz com que o ponteiro de Vector
-                          // aponte para o mesmo recurso que do 'other'.
-        other.elem =
-            nullptr;   // deve-se então, para completar a operação de 'move',
-                       // tornar nulo o ponteiro do vetor 'other' original.
-        other.sz = 0;  // idem para o tamanho 'sz';
+          sz{other.sz},
+          cap{other.cap} {  // elem{other.elem} faz com que o ponteiro de
+                            // Vector aponte para o mesmo recurso que do
+                            // 'other'.
+        if (other.is_inline()) {  // o buffer interno não pode ser "roubado":
+                                  // os elementos são copiados.
+            elem = buf.data();
+            std::copy_n(other.elem, sz, elem);
+        }
+        other.reset();  // deve-se então, para completar a operação de 'move',
+                        // tornar nulo o ponteiro do vetor 'other' original
+                        // (ou apontá-lo para o seu buffer interno), e zerar o
+                        // tamanho 'sz'.
     };
     Vector& operator=(Vector&& other) {
-        elem = other.elem;
+        if (this == &other) {
+            return *this;
+        }
+        release();
+        elem = other.is_inline() ? buf.data() : other.elem;
         sz = other.sz;
-        other.elem = nullptr;
-        other.sz = 0;
+        cap = other.cap;
+        if (other.is_inline()) {
+            std::copy_n(other.elem, sz, elem);
+        }
+        other.reset();
         return *this;
     };
     ~Vector() {
-        delete[] elem;
+        release();
     }  // destructor: liberação do recurso previamento alocado
     double& operator[](int i) {
         if (!(0 <= i && i < size())) {
@@ -163,6 +233,58 @@ class Vector {
         }
         return elem[i];
     };
+    // intervalo verificado uma única vez; acesso sem verificação pelo 'span'.
+    std::span<double> view(int first, int count) {
+        if (!containers::in_bounds(first, count, sz)) {
+            throw std::out_of_range("Vector::view");
+        }
+        return {elem + first, static_cast<std::size_t>(count)};
+    }
+    std::span<double> view() { return {elem, static_cast<std::size_t>(sz)}; }
+    std::span<const double> view() const {
+        return {elem, static_cast<std::size_t>(sz)};
+    }
+
+    // '+', '-', '*' e '/' (ver abaixo da classe) não calculam nada: devolvem
+    // a expressão. a atribuição a um 'Vector' avalia a expressão inteira num
+    // único laço, elemento a elemento, sem nenhum 'Vector' temporário. como
+    // cada elemento do resultado depende apenas dos elementos de mesmo índice
+    // dos operandos, 'a = a + b' é seguro, e o laço pode ser vetorizado.
+    template <Expression E>
+    Vector(const E& e) : Vector() {
+        *this = e;
+    }
+    template <Expression E>
+    Vector& operator=(const E& e) {
+        const int n = e.size();
+        if (n != sz) {  // de outro tamanho, 'e' não pode conter este Vector
+            double* p = allocate(n);
+            if (p != elem) {
+                release();
+            }
+            elem = p;
+            sz = n;
+            cap = capacity_for(n);
+        }
+        double* out = elem;
+#pragma omp simd
+        for (int i = 0; i < n; i++) {
+            out[i] = e[i];
+        }
+        return *this;
+    }
+    template <typename E>
+    Vector& operator+=(const E& e) {
+        return *this = *this + e;
+    }
+    template <typename E>
+    Vector& operator-=(const E& e) {
+        return *this = *this - e;
+    }
+    template <typename E>
+    Vector& operator*=(const E& e) {
+        return *this = *this * e;
+    }
 
     // Vários dos operadores comuns (+, -, >, &&, [], etc) podem ser
     // sobrescritos para tender os tipos próprios definidos (itens 6.4 - 6.5).
@@ -172,14 +294,60 @@ class Vector {
     // comparação 'three-way', o valor 0 representa a equalidade, negativo
     // quando Vector for menor que 'other' e positivo quando Vector for maior
     // que 'other'.
-    auto operator<=>(const Vector& other) const {
-        return size() == other.size() ? 0 : size() < other.size() ? -1 : 1;
+    //
+    // aqui a comparação é pelo conteúdo, em ordem lexicográfica (como a de
+    // 'std::vector'), e o primeiro elemento diferente é procurado um
+    // registrador SIMD por vez. o resultado é 'partial_ordering': com um 'NaN'
+    // no primeiro elemento diferente, os vetores não são ordenáveis.
+    std::partial_ordering operator<=>(const Vector& other) const {
+        const auto a = view();
+        const auto b = other.view();
+        const std::size_t i = simd::mismatch(a, b);
+        if (i < a.size() && i < b.size()) {
+            return a[i] <=> b[i];
+        }
+        return size() <=> other.size();
     }
-    auto operator==(const Vector& other) const {
-        return size() == other.size();
+    bool operator==(const Vector& other) const {
+        return size() == other.size() &&
+               simd::mismatch(view(), other.view()) == view().size();
     }
     int size() const { return sz; };
-    void push_back(double d);
+    int capacity() const { return cap; }
+
+    // crescimento geométrico (a capacidade dobra): 'push_back' custa O(1)
+    // amortizado. como 'double' é trivial, 'memory::resize_array' usa o
+    // 'reallocate' da política, quando houver ('memory::Malloc',
+    // 'memory::HugePage', 'memory::Numa'), e o buffer cresce no lugar ou tem as
+    // páginas remapeadas, em vez de ser copiado a cada vez que dobra.
+    void push_back(double d) {
+        if (sz == cap) {
+            set_capacity(grown_capacity());
+        }
+        elem[sz++] = d;
+    }
+    void reserve(int n) {
+        if (n < 0) {
+            throw std::length_error{"Vector::reserve: negative size"};
+        }
+        if (n > cap) {
+            set_capacity(n);
+        }
+    }
+    void shrink_to_fit() {
+        if (sz == cap || is_inline()) {
+            return;
+        }
+        if (sz == 0) {
+            release();
+            reset();
+            return;
+        }
+        set_capacity(sz);
+    }
+    bool is_inline() const {
+        return InlineCapacity > 0 && elem == buf.data();
+    }
 
     // operadores de containers involvem em boa parte 'iteradores'. Basicamente
     // todo container definido pela stl possui os métodos 'begin()' e 'end()',
@@ -198,9 +366,366 @@ class Vector {
     // para fazer uso de 'std::swap') e 'hash<>'.
 
    private:
+    static int capacity_for(int n) {
+        return n <= InlineCapacity ? InlineCapacity : n;
+    }
+    double* allocate(int n) {
+        if (n <= InlineCapacity) {
+            return buf.data();
+        }
+        return memory::new_array<double, Allocation>(n);
+    }
+    void release() {
+        if (!is_inline()) {
+            memory::delete_array<double, Allocation>(elem, cap);
+        }
+    }
+    void reset() {
+        elem = InlineCapacity > 0 ? buf.data() : nullptr;
+        sz = 0;
+        cap = InlineCapacity;
+    }
+
+    // o dobro, limitado a 'int': perto de 2^30 elementos, '2 * cap' estouraria
+    // (comportamento indefinido) e daria uma capacidade negativa.
+    int grown_capacity() const {
+        constexpr int max = std::numeric_limits<int>::max();
+        if (cap == max) {
+            throw std::length_error{"Vector::push_back: too many elements"};
+        }
+        return cap < 8 ? 8 : cap > max / 2 ? max : 2 * cap;
+    }
+
+    void set_capacity(int n) {
+        if (n < 0 || n < sz) {  // perderia elementos
+            throw std::length_error{"Vector: capacity below size"};
+        }
+        if (n <= InlineCapacity) {  // 'shrink_to_fit': de volta ao buffer
+            std::copy_n(elem, sz, buf.data());
+            release();
+            elem = buf.data();
+            cap = InlineCapacity;
+            return;
+        }
+        if (is_inline()) {  // do buffer interno para a memória alocada
+            double* p = memory::new_array<double, Allocation>(n);
+            std::copy_n(elem, sz, p);
+            elem = p;
+        } else {
+            elem = memory::resize_array<double, Allocation>(elem, cap, n, sz);
+        }
+        cap = n;
+    }
+
     double* elem;
     int sz;
+    int cap;  // elementos alocados; 'sz <= cap'
+    [[no_unique_address]] InlineBuffer<InlineCapacity> buf;
 };
 
+// vetor com até 'N' elementos dentro do próprio objeto.
+template <int N = 16>
+using SmallVector = Vector<memory::DefaultAllocation, N>;
+}  // namespace capitulo_6
+
+// hash do conteúdo, compatível com 'operator==': 'Vector' pode ser chave de
+// 'std::unordered_map'/'std::unordered_set'.
+template <memory::AllocationPolicy Allocation, int InlineCapacity>
+struct std::hash<capitulo_6::Vector<Allocation, InlineCapacity>> {
+    std::size_t operator()(
+        const capitulo_6::Vector<Allocation, InlineCapacity>& v) const {
+        return simd::hash(v.view());
+    }
+};
+
+namespace capitulo_6 {
+
+// ----- expression templates -----
+
+template <typename T>
+struct is_vector : std::false_type {};
+template <memory::AllocationPolicy Allocation, int InlineCapacity>
+struct is_vector<Vector<Allocation, InlineCapacity>> : std::true_type {};
+
+template <typename T>
+concept VectorOperand = is_vector<T>::value || Expression<T>;
+template <typename T>
+concept Operand = VectorOperand<T> || std::is_arithmetic_v<T>;
+
+// folhas: um 'Vector', guardado como 'span' (a expressão não é dona dos
+// dados: 'auto e = a + b;' só vale enquanto 'a' e 'b' existirem), e um escalar
+// repetido em todas as posições.
+struct VectorRef {
+    static constexpr bool is_expression = true;
+    std::span<const double> s;
+    int size() const { return static_cast<int>(s.size()); }
+    double operator[](int i) const { return s[i]; }
+};
+struct Broadcast {
+    static constexpr bool is_expression = false;
+    double v;
+    int size() const { return -1; }  // combina com qualquer tamanho
+    double operator[](int) const { return v; }
+};
+
+template <typename T>
+auto as_expression(const T& x) {
+    if constexpr (is_vector<T>::value) {
+        return VectorRef{x.view()};
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        return Broadcast{static_cast<double>(x)};
+    } else {
+        return x;
+    }
+}
+
+// os nós são guardados por valor: são pequenos (spans, escalares e outros
+// nós), e o compilador expande 'operator[]' da expressão inteira no laço.
+template <typename Op, typename L, typename R>
+struct BinaryExpression {
+    static constexpr bool is_expression = true;
+    L l;
+    R r;
+    BinaryExpression(L l, R r) : l{l}, r{r} {
+        // tamanhos verificados uma única vez, ao montar a expressão.
+        if (l.size() >= 0 && r.size() >= 0 && l.size() != r.size()) {
+            throw std::length_error{"Vector expression: different sizes"};
+        }
+    }
+    int size() const { return l.size() >= 0 ? l.size() : r.size(); }
+    double operator[](int i) const { return Op{}(l[i], r[i]); }
+};
+
+template <typename Op, typename E>
+struct UnaryExpression {
+    static constexpr bool is_expression = true;
+    E e;
+    int size() const { return e.size(); }
+    double operator[](int i) const { return Op{}(e[i]); }
+};
+
+template <typename Op, typename L, typename R>
+auto make_expression(const L& l, const R& r) {
+    using LE = decltype(as_expression(l));
+    using RE = decltype(as_expression(r));
+    return BinaryExpression<Op, LE, RE>{as_expression(l), as_expression(r)};
+}
+
+template <Operand L, Operand R>
+    requires VectorOperand<L> || VectorOperand<R>
+auto operator+(const L& l, const R& r) {
+    return make_expression<std::plus<>>(l, r);
+}
+template <Operand L, Operand R>
+    requires VectorOperand<L> || VectorOperand<R>
+auto operator-(const L& l, const R& r) {
+    return make_expression<std::minus<>>(l, r);
+}
+template <Operand L, Operand R>
+    requires VectorOperand<L> || VectorOperand<R>
+auto operator*(const L& l, const R& r) {
+    return make_expression<std::multiplies<>>(l, r);
+}
+template <Operand L, Operand R>
+    requires VectorOperand<L> || VectorOperand<R>
+auto operator/(const L& l, const R& r) {
+    return make_expression<std::divides<>>(l, r);
+}
+template <VectorOperand E>
+auto operator-(const E& e) {
+    using EE = decltype(as_expression(e));
+    return UnaryExpression<std::negate<>, EE>{as_expression(e)};
+}
+
+// redução de uma expressão, também sem temporários: 'sum(a * b)' é o produto
+// escalar, numa única passagem por 'a' e 'b'.
+template <VectorOperand E>
+double sum(const E& e) {
+    const auto x = as_expression(e);
+    const int n = x.size();
+    double s = 0.0;
+#pragma omp simd reduction(+ : s)
+    for (int i = 0; i < n; i++) {
+        s += x[i];
+    }
+    return s;
+}
+
 void main() {};
+
+template <memory::AllocationPolicy Allocation>
+void push_back_n(int n) {
+    Vector<Allocation> v;
+    for (int i = 0; i < n; i++) {
+        v.push_back(i);
+    }
+    benchmark::do_not_optimize(v[n - 1]);
+}
+
+// cria e destrói 'Vector' curtos, como na maior parte do uso real. com
+// '--alloc', o relatório mostra as alocações por execução (zero com o buffer
+// interno).
+template <typename V>
+void create_destroy(int n) {
+    for (int k = 0; k < 1000; k++) {
+        V v(n, 1.0);
+        benchmark::do_not_optimize(v[0]);
+    }
+}
+
+// 'd = a + b * c' como seria com operadores que devolvem um 'Vector': um
+// temporário para 'b * c', e duas passagens pela memória.
+void naive_mul_add(Vector<>& d, Vector<>& a, Vector<>& b, Vector<>& c) {
+    auto as = a.view();
+    auto bs = b.view();
+    auto cs = c.view();
+    Vector<> t(a.size());
+    auto ts = t.view();
+    for (std::size_t i = 0; i < ts.size(); i++) {
+        ts[i] = bs[i] * cs[i];
+    }
+    Vector<> res(a.size());
+    auto rs = res.view();
+    for (std::size_t i = 0; i < rs.size(); i++) {
+        rs[i] = as[i] + ts[i];
+    }
+    d = std::move(res);
+}
+
+// igualdade e hash elemento a elemento, como seriam sem os kernels SIMD.
+bool equal_loop(const Vector<>& a, const Vector<>& b) {
+    const auto as = a.view();
+    const auto bs = b.view();
+    if (as.size() != bs.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < as.size(); i++) {
+        if (as[i] != bs[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t hash_loop(const Vector<>& v) {
+    std::size_t h = std::hash<int>{}(v.size());
+    for (double x : v.view()) {  // 'hash_combine' do Boost
+        h ^= std::hash<double>{}(x) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+// 'count' vetores de 'n' elementos, com um quarto de valores distintos.
+std::vector<Vector<>> dedup_input(int count, int n) {
+    std::vector<Vector<>> vs;
+    vs.reserve(count);
+    for (int k = 0; k < count; k++) {
+        Vector<> v(n, 1.0);
+        v[n - 1] = k % (count / 4);  // iguais até o último elemento
+        vs.push_back(std::move(v));
+    }
+    return vs;
+}
+
+void benchmarks() {
+    for (int n : {16, 1 << 10, 1 << 20}) {
+        benchmark::add(std::format("capitulo_6/vector_copy/{}", n),
+                       [v = Vector(n, 1.0)] {
+                           Vector c{v};
+                           benchmark::do_not_optimize(c[0]);
+                       });
+    }
+    for (int n : {4, 16, 64}) {
+        benchmark::add(std::format("capitulo_6/create_destroy/heap/{}", n),
+                       [n] { create_destroy<Vector<>>(n); });
+        benchmark::add(
+            std::format("capitulo_6/create_destroy/inline16/{}", n),
+            [n] { create_destroy<SmallVector<16>>(n); });
+        benchmark::add(
+            std::format("capitulo_6/copy/inline16/{}", n),
+            [v = SmallVector<16>(n, 1.0)] {
+                SmallVector<16> c{v};
+                benchmark::do_not_optimize(c[0]);
+            });
+    }
+    // expressão inteira num laço contra um temporário por operação.
+    for (int n : {1 << 10, 1 << 22}) {
+        auto abcd = benchmark::lazy([n] {
+            return std::array{Vector(n, 1.0), Vector(n, 2.0), Vector(n, 0.5),
+                              Vector(n, 0.0)};
+        });
+        benchmark::add(std::format("capitulo_6/expression/naive/{}", n),
+                       [abcd] {
+                           auto& [a, b, c, d] = abcd();
+                           naive_mul_add(d, a, b, c);
+                           benchmark::do_not_optimize(d[0]);
+                       });
+        benchmark::add(std::format("capitulo_6/expression/fused/{}", n),
+                       [abcd] {
+                           auto& [a, b, c, d] = abcd();
+                           d = a + b * c;
+                           benchmark::do_not_optimize(d[0]);
+                       });
+        benchmark::add(std::format("capitulo_6/expression/dot_naive/{}", n),
+                       [abcd] {
+                           auto& [a, b, c, d] = abcd();
+                           Vector<> t = a * b;  // um 'Vector' intermediário
+                           benchmark::do_not_optimize(sum(t));
+                       });
+        benchmark::add(std::format("capitulo_6/expression/dot_fused/{}", n),
+                       [abcd] {
+                           auto& [a, b, c, d] = abcd();
+                           benchmark::do_not_optimize(sum(a * b));
+                       });
+    }
+    // comparação e hash de vetores iguais: o pior caso, que percorre tudo.
+    for (int n : {64, 1 << 16}) {
+        auto ab = benchmark::lazy(
+            [n] { return std::array{Vector(n, 1.0), Vector(n, 1.0)}; });
+        benchmark::add(std::format("capitulo_6/equal/loop/{}", n), [ab] {
+            auto& [a, b] = ab();
+            benchmark::do_not_optimize(equal_loop(a, b));
+        });
+        benchmark::add(std::format("capitulo_6/equal/simd/{}", n), [ab] {
+            auto& [a, b] = ab();
+            benchmark::do_not_optimize(a == b);
+        });
+        benchmark::add(std::format("capitulo_6/hash/loop/{}", n), [ab] {
+            benchmark::do_not_optimize(hash_loop(ab()[0]));
+        });
+        benchmark::add(std::format("capitulo_6/hash/simd/{}", n), [ab] {
+            benchmark::do_not_optimize(std::hash<Vector<>>{}(ab()[0]));
+        });
+    }
+    // 'Vector' como chave de 'std::unordered_set'.
+    for (int n : {16, 1024}) {
+        auto vs = benchmark::lazy([n] { return dedup_input(4096, n); });
+        benchmark::add(std::format("capitulo_6/dedup/4096/{}", n), [vs] {
+            std::unordered_set<Vector<>> unique;
+            for (const auto& v : vs()) {
+                unique.insert(v);
+            }
+            benchmark::do_not_optimize(unique.size());
+        });
+    }
+    // 'n' 'push_back' a partir de um Vector vazio. com 'Aligned<>' (o padrão),
+    // cada dobra aloca, copia e libera; com 'Malloc' e 'HugePage<>', o buffer
+    // cresce com 'realloc'/'mremap'.
+    for (int n : {1 << 20, 1 << 24}) {
+        benchmark::add(std::format("capitulo_6/push_back/std_vector/{}", n),
+                       [n] {
+                           std::vector<double> v;
+                           for (int i = 0; i < n; i++) {
+                               v.push_back(i);
+                           }
+                           benchmark::do_not_optimize(v.back());
+                       });
+        benchmark::add(std::format("capitulo_6/push_back/aligned/{}", n),
+                       [n] { push_back_n<memory::Aligned<>>(n); });
+        benchmark::add(std::format("capitulo_6/push_back/malloc/{}", n),
+                       [n] { push_back_n<memory::Malloc>(n); });
+        benchmark::add(std::format("capitulo_6/push_back/huge_page/{}", n),
+                       [n] { push_back_n<memory::HugePage<>>(n); });
+    }
+}
 }  // namespace capitulo_6
@@ -1,22 +1,34 @@
+#include <algorithm>
 #include <cassert>
 #include <format>
 #include <iostream>
+#include <iterator>
 #include <list>
 #include <map>
 #include <numeric>
 #include <print>
+#include <random>
 #include <ranges>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+#include "containers/unchecked.hpp"
+#include "memory/allocation.hpp"
+
 void print(auto&& v) { std::println("{}", v); }
 
 namespace capitulo_7 {
-template <typename T>
+template <typename T,
+          memory::AllocationPolicy Allocation = memory::DefaultAllocation>
 class Vector {
    public:
     Vector() : elem{nullptr}, sz{0} {}
@@ -27,43 +39,94 @@ class Vector {
         if (s == 0) {
             throw std::length_error{"Vector constructor: zero size"};
         }
-        elem = new T[s];
+        elem = memory::new_array<T, Allocation>(s);
         sz = s;
     };
 
     template <typename Iter>
     Vector(Iter, Iter){};  // Construtor para o caso de se construir à partir de
                            // dois iteradores
-    struct Iterator {
-        using iterator_category = std::forward_iterator_tag;
+    // iterador contíguo: além de '++', tem aritmética de ponteiros e
+    // 'std::to_address' (pelo 'operator->'). com ele, os algoritmos da
+    // biblioteca padrão usam as versões de acesso aleatório ('std::sort') e,
+    // quando 'T' é trivialmente copiável, 'memmove' ('std::ranges::copy').
+    // 'U' é 'T' ou 'const T'.
+    template <typename U>
+    class BasicIterator {
+       public:
+        using iterator_concept = std::contiguous_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
         using difference_type = std::ptrdiff_t;
-        using value_type = T;
-        using pointer = T*;
-        using reference = T&;
+        using value_type = std::remove_cv_t<U>;
+        using pointer = U*;
+        using reference = U&;
 
-        Iterator(T* p) : m_ptr{p} {};
+        BasicIterator() = default;
+        explicit BasicIterator(U* p) : m_ptr{p} {}
+        // 'Iterator' converte para 'ConstIterator', e não o contrário.
+        template <typename V>
+            requires std::is_convertible_v<V*, U*>
+        BasicIterator(BasicIterator<V> other) : m_ptr{other.m_ptr} {}
 
-        T& operator*() { return *m_ptr; };
-        T* operator->() { return m_ptr; };
-        Iterator& operator++() {
+        U& operator*() const { return *m_ptr; }
+        U* operator->() const { return m_ptr; }
+        U& operator[](difference_type n) const { return m_ptr[n]; }
+
+        BasicIterator& operator++() {
             m_ptr++;
             return *this;
         }
-        Iterator operator++(int) {
-            Iterator tmp = *this;
+        BasicIterator operator++(int) {
+            BasicIterator tmp = *this;
             ++(*this);
             return tmp;
         }
-        friend bool operator==(const Iterator& a, const Iterator& b) {
-            return a.m_ptr == b.m_ptr;
-        };
-        friend bool operator!=(const Iterator& a, const Iterator& b) {
-            return a.m_ptr != b.m_ptr;
-        };
+        BasicIterator& operator--() {
+            m_ptr--;
+            return *this;
+        }
+        BasicIterator operator--(int) {
+            BasicIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+        BasicIterator& operator+=(difference_type n) {
+            m_ptr += n;
+            return *this;
+        }
+        BasicIterator& operator-=(difference_type n) {
+            m_ptr -= n;
+            return *this;
+        }
+        friend BasicIterator operator+(BasicIterator it, difference_type n) {
+            return it += n;
+        }
+        friend BasicIterator operator+(difference_type n, BasicIterator it) {
+            return it += n;
+        }
+        friend BasicIterator operator-(BasicIterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const BasicIterator& a,
+                                         const BasicIterator& b) {
+            return a.m_ptr - b.m_ptr;
+        }
+        friend bool operator==(const BasicIterator& a,
+                               const BasicIterator& b) = default;
+        friend auto operator<=>(const BasicIterator& a,
+                                const BasicIterator& b) = default;
 
        private:
-        T* m_ptr;
+        template <typename>
+        friend class BasicIterator;
+
+        U* m_ptr{nullptr};
     };
+    using Iterator = BasicIterator<T>;
+    using ConstIterator = BasicIterator<const T>;
+    using iterator = Iterator;
+    using const_iterator = ConstIterator;
+    using value_type = T;
 
     Vector(int s, T valor) {
         if (s < 0) {
@@ -72,43 +135,45 @@ class Vector {
         if (s == 0) {
             throw std::length_error{"Vector constructor: zero size"};
         }
-        elem = new T[s];
+        elem = memory::new_array<T, Allocation>(s);
         sz = s;
         for (int i = 0; i < s; i++) {
             elem[i] = valor;
         }
     };
     Vector(std::initializer_list<T>&& list)
-        : elem{new T[list.size()]}, sz{static_cast<int>(list.size())} {
+        : elem{memory::new_array<T, Allocation>(list.size())},
+          sz{static_cast<int>(list.size())} {
         std::ranges::copy(list, elem);
     }
-    Vector(const Vector<T>& other) : elem{new T[other.sz]}, sz{other.sz} {
+    Vector(const Vector& other)
+        : elem{memory::new_array<T, Allocation>(other.sz)}, sz{other.sz} {
         for (int i = 0; i < sz; i++) {
             elem[i] = other.elem[i];
         }
     }
-    Vector& operator=(const Vector<T>& other) {
-        double* p = new T[other.sz];
+    Vector& operator=(const Vector& other) {
+        T* p = memory::new_array<T, Allocation>(other.sz);
         for (int i = 0; i < other.sz; i++) {
             p[i] = other.elem[i];
         }
-        delete[] elem;
+        memory::delete_array<T, Allocation>(elem, sz);
         elem = p;
         sz = other.sz;
         return *this;
     }
-    Vector(Vector<T>&& other) : elem{other.elem}, sz{other.sz} {
+    Vector(Vector&& other) : elem{other.elem}, sz{other.sz} {
         other.elem = nullptr;
         other.sz = 0;
     };
-    Vector& operator=(Vector<T>&& other) {
+    Vector& operator=(Vector&& other) {
         elem = other.elem;
         sz = other.sz;
         other.elem = nullptr;
         other.sz = 0;
         return *this;
     };
-    ~Vector() { delete[] elem; }
+    ~Vector() { memory::delete_array<T, Allocation>(elem, sz); }
     T& operator[](int i) {  // para Vector não-const
         if (!(0 <= i && i < size())) {
             throw std::out_of_range("Vector::operator[]");
@@ -121,20 +186,45 @@ class Vector {
         }
         return elem[i];
     };
-    auto operator<=>(const Vector<T>& other) const {
+    // intervalo verificado uma única vez; acesso sem verificação pelo 'span'.
+    std::span<T> view(int first, int count) {
+        check_view(first, count);
+        return {elem + first, static_cast<std::size_t>(count)};
+    }
+    std::span<const T> view(int first, int count) const {
+        check_view(first, count);
+        return {elem + first, static_cast<std::size_t>(count)};
+    }
+    std::span<T> view() { return {elem, static_cast<std::size_t>(sz)}; }
+    std::span<const T> view() const {
+        return {elem, static_cast<std::size_t>(sz)};
+    }
+    auto operator<=>(const Vector& other) const {
         return size() == other.size() ? 0 : size() < other.size() ? -1 : 1;
     }
-    auto operator==(const Vector<T>& other) const {
+    auto operator==(const Vector& other) const {
         return size() == other.size();
     }
     int size() const { return sz; };
+    T* data() { return elem; }
+    const T* data() const { return elem; }
     // T* begin() const { return &elem[0]; };
-    Iterator begin() const { return Iterator(&elem[0]); };
+    Iterator begin() { return Iterator(elem); };
+    ConstIterator begin() const { return ConstIterator(elem); };
+    ConstIterator cbegin() const { return begin(); };
     // T* end() const { return &elem[0] + size(); };
-    Iterator end() const { return Iterator(&elem[0] + size()); };
+    Iterator end() { return Iterator(elem + sz); };
+    ConstIterator end() const { return ConstIterator(elem + sz); };
+    ConstIterator cend() const { return end(); };
     void push_back(T d);
 
    private:
+    void check_view(int first, int count) const {
+        if (!containers::in_bounds(first, count, sz)) {
+            throw std::out_of_range("Vector::view");
+        }
+    }
+
     T* elem;  // elem agora é um ponteiro para um array de tamanho 'sz' de tipo
               // 'T'
     int sz;
@@ -146,6 +236,10 @@ class Vector {
 template <typename Iter>
 Vector(Iter, Iter) -> Vector<typename Iter::value_type>;
 
+static_assert(std::contiguous_iterator<Vector<int>::Iterator>);
+static_assert(std::contiguous_iterator<Vector<int>::ConstIterator>);
+static_assert(std::ranges::contiguous_range<const Vector<double>>);
+
 void write(const Vector<std::string>& vs) {
     for (auto& v : vs) {
         std::cout << v << std::endl;
@@ -355,4 +449,122 @@ void main() {
 
     StringMap<int> m;
 };
+
+// o 'Iterator' de antes: apenas '++', '*' e '=='. com ele, os algoritmos
+// ficam nas versões genéricas, elemento a elemento, e 'std::sort' nem compila.
+template <typename It>
+class ForwardOnly {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::iter_value_t<It>;
+    using pointer = void;
+    using reference = std::iter_reference_t<It>;
+
+    ForwardOnly() = default;
+    explicit ForwardOnly(It it) : m_it{it} {}
+    reference operator*() const { return *m_it; }
+    ForwardOnly& operator++() {
+        ++m_it;
+        return *this;
+    }
+    ForwardOnly operator++(int) {
+        ForwardOnly tmp = *this;
+        ++m_it;
+        return tmp;
+    }
+    friend bool operator==(const ForwardOnly&, const ForwardOnly&) = default;
+
+   private:
+    It m_it{};
+};
+
+template <typename T>
+Vector<T> shuffled(int n) {
+    Vector<T> v(n);
+    std::iota(v.begin(), v.end(), T{0});
+    std::ranges::shuffle(v, std::mt19937{42});
+    return v;
+}
+
+// cópia, busca (de um valor ausente: percorre tudo) e ordenação, pelo
+// iterador só de avanço e pelo iterador contíguo.
+template <typename T>
+void add_iterator_benchmarks(std::string_view type, int n) {
+    auto io = benchmark::lazy(
+        [n] { return std::pair{shuffled<T>(n), Vector<T>(n, T{0})}; });
+    const auto name = [type, n](std::string_view kernel) {
+        return std::format("capitulo_7/{}/{}/{}", kernel, type, n);
+    };
+    const T missing = -1;
+    benchmark::add(name("copy/forward"), [io] {
+        auto& [in, out] = io();
+        std::copy(ForwardOnly{in.begin()}, ForwardOnly{in.end()},
+                  ForwardOnly{out.begin()});
+        benchmark::clobber_memory();
+    });
+    benchmark::add(name("copy/contiguous"), [io] {
+        auto& [in, out] = io();
+        std::ranges::copy(in, out.begin());
+        benchmark::clobber_memory();
+    });
+    benchmark::add(name("find/forward"), [io, missing] {
+        const auto& in = io().first;
+        benchmark::do_not_optimize(
+            std::find(ForwardOnly{in.begin()}, ForwardOnly{in.end()}, missing)
+            == ForwardOnly{in.end()});
+    });
+    benchmark::add(name("find/contiguous"), [io, missing] {
+        const auto& in = io().first;
+        benchmark::do_not_optimize(std::ranges::find(in, missing) == in.end());
+    });
+    // sem acesso aleatório, a saída é ordenar uma cópia num 'std::vector'.
+    benchmark::add(name("sort/forward"), [io] {
+        auto& [in, out] = io();
+        std::vector<T> tmp(ForwardOnly{in.begin()}, ForwardOnly{in.end()});
+        std::ranges::sort(tmp);
+        std::copy(tmp.begin(), tmp.end(), ForwardOnly{out.begin()});
+        benchmark::clobber_memory();
+    });
+    benchmark::add(name("sort/contiguous"), [io] {
+        auto& [in, out] = io();
+        std::ranges::copy(in, out.begin());
+        std::ranges::sort(out);
+        benchmark::clobber_memory();
+    });
+}
+
+void benchmarks() {
+    for (int n : {1 << 10, 1 << 20}) {
+        benchmark::add(std::format("capitulo_7/count/LessThan/{}", n),
+                       [v = Vector<double>(n, 1.5)] {
+                           benchmark::do_not_optimize(count(v, LessThan{2.0}));
+                       });
+        benchmark::add(std::format("capitulo_7/count/lambda/{}", n),
+                       [v = Vector<double>(n, 1.5)] {
+                           benchmark::do_not_optimize(
+                               count(v, [](double x) { return x < 2.0; }));
+                       });
+        benchmark::add(std::format("capitulo_7/sum/{}", n),
+                       [v = Vector<double>(n, 1.5)] {
+                           benchmark::do_not_optimize(sum(v, 0.0));
+                       });
+        // soma com 'operator[]' verificado, e pelo 'span' validado uma vez.
+        benchmark::add(std::format("capitulo_7/sum/checked/{}", n),
+                       [v = Vector<double>(n, 1.5)] {
+                           double s = 0.0;
+                           for (int i = 0; i < v.size(); i++) {
+                               s += v[i];
+                           }
+                           benchmark::do_not_optimize(s);
+                       });
+        benchmark::add(std::format("capitulo_7/sum/view/{}", n),
+                       [v = Vector<double>(n, 1.5)] {
+                           benchmark::do_not_optimize(
+                               containers::sum(v.view(0, v.size())));
+                       });
+        add_iterator_benchmarks<int>("int", n);
+        add_iterator_benchmarks<double>("double", n);
+    }
+}
 }  // namespace capitulo_7
@@ -14,6 +14,8 @@
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.hpp"
+
 void print(auto&& v) { std::println("{}", v); }
 
 namespace capitulo_8 {
@@ -302,4 +304,18 @@ void main() {
     print(sum('a', 2.4, 4.2, 3.9));
     print(3, " ", 2.4, " ", "foobar", " ", std::string{"world"});
 };
+
+void benchmarks() {
+    for (int n : {1 << 10, 1 << 20}) {
+        benchmark::add(std::format("capitulo_8/sum/{}", n),
+                       [v = std::vector<int>(n, 3)] {
+                           benchmark::do_not_optimize(sum(v));
+                       });
+        benchmark::add(std::format("capitulo_8/accumulate/{}", n),
+                       [v = std::vector<int>(n, 3)] {
+                           benchmark::do_not_optimize(capitulo_8::accumulate(
+                               v.begin(), v.end(), 0.0));
+                       });
+    }
+}
 }  // namespace capitulo_8
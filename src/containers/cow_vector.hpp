@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// vetor com 'copy-on-write': cópias compartilham o mesmo armazenamento, com um
+// contador de referências atômico, e os elementos só são de fato copiados na
+// primeira modificação feita por uma cópia não exclusiva. passar um
+// 'cow_vector' por valor custa um incremento atômico, e não O(n), enquanto o
+// chamado apenas lê os elementos.
+//
+// atenção: como em todo 'copy-on-write', as funções não 'const' ('begin()',
+// 'operator[]', 'data()', ...) separam a cópia mesmo quando usadas só para
+// leitura. para ler um 'cow_vector' não 'const', use 'std::as_const(v)',
+// 'cbegin()'/'cend()' ou 'get(i)'.
+//
+// o contador é seguro entre threads; o mesmo objeto 'cow_vector', como um
+// 'std::vector', não pode ser modificado por duas threads ao mesmo tempo.
+namespace containers {
+
+template <typename T>
+class cow_vector {
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    cow_vector() = default;
+    explicit cow_vector(size_type n, const T& value = T())
+        : m_storage{new Storage{std::vector<T>(n, value)}} {}
+    cow_vector(std::initializer_list<T> list)
+        : m_storage{new Storage{std::vector<T>(list)}} {}
+    template <std::input_iterator It>
+    cow_vector(It first, It last)
+        : m_storage{new Storage{std::vector<T>(first, last)}} {}
+    explicit cow_vector(std::vector<T> v)
+        : m_storage{new Storage{std::move(v)}} {}
+
+    // cópia: apenas compartilha o armazenamento.
+    cow_vector(const cow_vector& other) noexcept : m_storage{other.m_storage} {
+        if (m_storage) {
+            m_storage->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    cow_vector(cow_vector&& other) noexcept
+        : m_storage{std::exchange(other.m_storage, nullptr)} {}
+    cow_vector& operator=(cow_vector other) noexcept {
+        swap(*this, other);
+        return *this;
+    }
+    ~cow_vector() { release(); }
+
+    friend void swap(cow_vector& a, cow_vector& b) noexcept {
+        std::swap(a.m_storage, b.m_storage);
+    }
+
+    // ----- leitura: nunca copia -----
+    size_type size() const { return m_storage ? m_storage->data.size() : 0; }
+    bool empty() const { return size() == 0; }
+    size_type capacity() const {
+        return m_storage ? m_storage->data.capacity() : 0;
+    }
+    const T* data() const {
+        return m_storage ? m_storage->data.data() : nullptr;
+    }
+    const T& operator[](size_type i) const { return data()[i]; }
+    const T& get(size_type i) const { return data()[i]; }
+    const T& at(size_type i) const {
+        check(i);
+        return data()[i];
+    }
+    const T& front() const { return data()[0]; }
+    const T& back() const { return data()[size() - 1]; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // número de 'cow_vector' que compartilham o armazenamento.
+    long use_count() const {
+        return m_storage ? long(m_storage->refs.load(std::memory_order_relaxed))
+                         : 0;
+    }
+
+    // ----- modificação: copia antes, se o armazenamento é compartilhado -----
+    T* data() { return mutable_data().data(); }
+    T& operator[](size_type i) { return data()[i]; }
+    T& at(size_type i) {
+        check(i);
+        return data()[i];
+    }
+    T& front() { return data()[0]; }
+    T& back() { return data()[size() - 1]; }
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+
+    void push_back(const T& value) { mutable_data().push_back(value); }
+    void push_back(T&& value) { mutable_data().push_back(std::move(value)); }
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        return mutable_data().emplace_back(std::forward<Args>(args)...);
+    }
+    void pop_back() { mutable_data().pop_back(); }
+    void resize(size_type n) { mutable_data().resize(n); }
+    void resize(size_type n, const T& value) {
+        mutable_data().resize(n, value);
+    }
+    void reserve(size_type n) { mutable_data().reserve(n); }
+    void clear() {  // não há por que copiar o que será descartado
+        release();
+        m_storage = nullptr;
+    }
+
+    friend bool operator==(const cow_vector& a, const cow_vector& b) {
+        return a.m_storage == b.m_storage ||
+               std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend auto operator<=>(const cow_vector& a, const cow_vector& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(),
+                                                      b.begin(), b.end());
+    }
+
+   private:
+    struct Storage {
+        std::vector<T> data;
+        std::atomic<std::size_t> refs{1};
+    };
+
+    void check(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range{"cow_vector::at"};
+        }
+    }
+
+    // se houver outro dono, faz a cópia privada dos elementos. com um único
+    // dono, nenhuma outra thread pode criar uma nova referência, então ler o
+    // contador basta.
+    std::vector<T>& mutable_data() {
+        if (!m_storage) {
+            m_storage = new Storage{};
+        } else if (m_storage->refs.load(std::memory_order_acquire) != 1) {
+            auto* copy = new Storage{m_storage->data};
+            release();
+            m_storage = copy;
+        }
+        return m_storage->data;
+    }
+
+    void release() {
+        if (m_storage &&
+            m_storage->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete m_storage;
+        }
+    }
+
+    Storage* m_storage{nullptr};
+};
+
+}  // namespace containers
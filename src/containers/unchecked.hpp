@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <type_traits>
+
+// acesso "validado uma vez": em vez de verificar os limites em cada
+// 'operator[]', o container verifica um intervalo [first, first + count) uma
+// única vez e devolve um 'std::span', que não faz verificação alguma. um laço
+// sobre o 'span' não tem desvios por elemento, e pode ser vetorizado.
+//
+//     containers::iota(v.view(), 1.0);       // em vez de v[i] = ... (checado)
+//     double s = containers::sum(v.view(0, 100));
+namespace containers {
+
+// 'first' e 'count' são verificados juntos, sem risco de 'overflow' em
+// 'first + count'.
+constexpr bool in_bounds(std::ptrdiff_t first, std::ptrdiff_t count,
+                         std::ptrdiff_t size) {
+    return 0 <= first && 0 <= count && first <= size && count <= size - first;
+}
+
+template <typename T>
+void fill(std::span<T> s, const std::type_identity_t<T>& value) {
+    for (T& x : s) {
+        x = value;
+    }
+}
+
+// 'value + i' em vez de incrementos sucessivos: sem dependência entre as
+// iterações, o laço é vetorizado também para ponto flutuante.
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void iota(std::span<T> s, std::type_identity_t<T> value) {
+    for (std::size_t i = 0; i < s.size(); i++) {
+        s[i] = value + static_cast<T>(i);
+    }
+}
+
+template <typename T>
+void scale(std::span<T> s, std::type_identity_t<T> factor) {
+    for (T& x : s) {
+        x *= factor;
+    }
+}
+
+// 'std::reduce' pode reassociar a soma (e, na libstdc++, usa vários
+// acumuladores), ao contrário de 'std::accumulate'.
+template <typename T>
+std::remove_cv_t<T> sum(std::span<T> s) {
+    return std::reduce(s.begin(), s.end(), std::remove_cv_t<T>{});
+}
+
+}  // namespace containers
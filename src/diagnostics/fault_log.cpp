@@ -0,0 +1,106 @@
+#include "diagnostics/fault_log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+namespace diagnostics {
+namespace {
+std::uint32_t thread_number() {
+    static std::atomic<std::uint32_t> next{0};
+    thread_local const std::uint32_t number =
+        next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// intervalo entre as rodadas da thread de formatação, com a fila vazia.
+constexpr auto drain_interval = std::chrono::milliseconds{10};
+}  // namespace
+
+FaultLog::FaultLog(Formatter formatter, std::size_t capacity)
+    : m_formatter{formatter},
+      m_slots{new Slot[std::bit_ceil(std::max<std::size_t>(capacity, 2))]},
+      m_mask{std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1} {
+    for (std::uint64_t i = 0; i <= m_mask; i++) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_worker = std::jthread{[this](std::stop_token stop) {
+        while (!stop.stop_requested()) {
+            // só dorme com a fila vazia: numa sequência de falhas, a thread
+            // acompanha os produtores em vez de deixar a fila encher.
+            if (drain() == 0) {
+                std::this_thread::sleep_for(drain_interval);
+            }
+        }
+        drain();
+    }};
+}
+
+FaultLog::~FaultLog() {
+    m_worker.request_stop();
+    m_worker.join();
+}
+
+bool FaultLog::push(std::uint32_t code) noexcept {
+    std::uint64_t pos = m_head.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &m_slots[pos & m_mask];
+        const std::uint64_t seq =
+            slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq - pos);
+        if (diff == 0) {  // posição livre nesta volta: tenta reservá-la
+            if (m_head.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {  // o consumidor ainda não liberou: fila cheia
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {  // outro produtor reservou esta posição
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->record = {code, thread_number(), now_ns()};
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool FaultLog::pop(FaultRecord& record) {
+    Slot& slot = m_slots[m_tail & m_mask];
+    if (slot.sequence.load(std::memory_order_acquire) != m_tail + 1) {
+        return false;  // vazia, ou o produtor ainda está escrevendo
+    }
+    record = slot.record;
+    // libera a posição para o produtor da próxima volta.
+    slot.sequence.store(m_tail + m_mask + 1, std::memory_order_release);
+    m_tail++;
+    return true;
+}
+
+std::size_t FaultLog::drain() {
+    FaultRecord record;
+    std::size_t count = 0;
+    while (pop(record)) {
+        m_formatter(record);
+        m_consumed.fetch_add(1, std::memory_order_release);
+        count++;
+    }
+    return count;
+}
+
+void FaultLog::flush() {
+    // só a thread de formatação consome: aqui apenas se espera por ela.
+    const std::uint64_t target = m_head.load(std::memory_order_acquire);
+    while (m_consumed.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+}
+
+}  // namespace diagnostics
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// registro de falhas de verificação ('expert', 'assert', ...) sem E/S no
+// caminho crítico. três níveis de custo, do menor para o maior:
+//
+// - 'FaultCounters': apenas conta as falhas, por thread e por código;
+// - 'FaultSampler': decide se a falha deve ser registrada (1 em cada N);
+// - 'FaultLog': guarda um registro compacto numa fila circular sem locks, e
+//   uma thread em segundo plano formata e escreve os registros.
+//
+// mesmo numa "tempestade" de falhas, a thread que falha nunca espera por E/S
+// nem por um lock.
+namespace diagnostics {
+
+// contadores de falhas por código de um 'enum class' 'Code' com 'N' valores.
+// cada thread incrementa o seu próprio bloco de contadores (sem operações
+// atômicas de leitura-modificação-escrita, pois há um único escritor), e
+// 'totals()' soma os blocos de todas as threads, inclusive as já encerradas.
+template <typename Code, std::size_t N>
+class FaultCounters {
+   public:
+    using Counts = std::array<std::uint64_t, N>;
+
+    static void add(Code code) {
+        auto& c = local().counts[std::size_t(code)];
+        c.store(c.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    }
+
+    static Counts thread_totals() { return read(local()); }
+
+    static Counts totals() {
+        Counts sum{};
+        std::lock_guard lock{registry().mutex};
+        for (const auto& block : registry().blocks) {
+            Counts c = read(*block);
+            for (std::size_t i = 0; i < N; i++) {
+                sum[i] += c[i];
+            }
+        }
+        return sum;
+    }
+
+   private:
+    struct Block {
+        std::array<std::atomic<std::uint64_t>, N> counts{};
+    };
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    static Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    static Block& local() {
+        constinit thread_local Block* block = nullptr;
+        if (block == nullptr) [[unlikely]] {
+            std::lock_guard lock{registry().mutex};
+            block = registry().blocks.emplace_back(new Block).get();
+        }
+        return *block;
+    }
+
+    static Counts read(const Block& block) {
+        Counts c;
+        for (std::size_t i = 0; i < N; i++) {
+            c[i] = block.counts[i].load(std::memory_order_relaxed);
+        }
+        return c;
+    }
+};
+
+// amostragem de 1 em cada 'Rate' falhas de cada código, por thread: a
+// primeira falha é sempre registrada.
+template <typename Code, std::size_t N, std::uint64_t Rate>
+class FaultSampler {
+    static_assert(Rate > 0);
+
+   public:
+    static bool sample(Code code) {
+        constinit thread_local std::array<std::uint64_t, N> seen{};
+        return seen[std::size_t(code)]++ % Rate == 0;
+    }
+};
+
+struct FaultRecord {
+    std::uint32_t code;
+    std::uint32_t thread;  // número sequencial da thread que falhou
+    std::int64_t time_ns;  // 'steady_clock', em nanossegundos
+};
+
+// fila circular limitada de múltiplos produtores e um único consumidor (o
+// algoritmo de D. Vyukov): cada posição guarda um número de sequência que diz
+// se ela está livre para o produtor da volta atual ou pronta para o
+// consumidor. com a fila cheia, o registro é descartado e contado, em vez de
+// bloquear quem falhou.
+class FaultLog {
+   public:
+    using Formatter = void (*)(const FaultRecord&);
+
+    // 'capacity' é arredondada para uma potência de 2.
+    explicit FaultLog(Formatter formatter, std::size_t capacity = 4096);
+    ~FaultLog();  // formata o que restar na fila
+    FaultLog(const FaultLog&) = delete;
+    FaultLog& operator=(const FaultLog&) = delete;
+
+    bool push(std::uint32_t code) noexcept;
+    // espera até que tudo o que foi aceito até aqui tenha sido formatado.
+    void flush();
+    std::uint64_t dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+   private:
+    struct Slot {
+        std::atomic<std::uint64_t> sequence;
+        FaultRecord record;
+    };
+
+    bool pop(FaultRecord& record);
+    std::size_t drain();  // registros formatados
+
+    Formatter m_formatter;
+    std::unique_ptr<Slot[]> m_slots;
+    std::uint64_t m_mask;
+    alignas(64) std::atomic<std::uint64_t> m_head{0};  // próximo a produzir
+    alignas(64) std::uint64_t m_tail{0};  // próximo a consumir (consumidor)
+    std::atomic<std::uint64_t> m_consumed{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+    std::jthread m_worker;
+};
+
+}  // namespace diagnostics
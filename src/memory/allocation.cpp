@@ -0,0 +1,114 @@
+#include "memory/allocation.hpp"
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace memory::detail {
+namespace {
+std::size_t round_up(std::size_t bytes, std::size_t to) {
+    return (bytes + to - 1) / to * to;
+}
+
+void* map_anonymous(std::size_t bytes, int flags = 0) {
+    void* p = mmap(nullptr, bytes == 0 ? 1 : bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+}  // namespace
+
+void* map_huge(std::size_t bytes) {
+    const std::size_t size = round_up(bytes, huge_page);
+    if (void* p = map_anonymous(size, MAP_HUGETLB)) {
+        return p;
+    }
+    // páginas grandes transparentes: o kernel só as usa em regiões alinhadas
+    // a 2 MiB, então se mapeia uma página grande a mais e se descartam as
+    // sobras do começo e do fim.
+    auto* raw = static_cast<std::byte*>(map_anonymous(size + huge_page));
+    if (raw == nullptr) {
+        throw std::bad_alloc{};
+    }
+    const auto addr = reinterpret_cast<std::uintptr_t>(raw);
+    auto* p = raw + (round_up(addr, huge_page) - addr);
+    if (p != raw) {
+        munmap(raw, p - raw);
+    }
+    munmap(p + size, raw + size + huge_page - (p + size));
+    madvise(p, size, MADV_HUGEPAGE);  // apenas um pedido: falhar não é erro
+    return p;
+}
+
+void unmap_huge(void* p, std::size_t bytes) {
+    if (p != nullptr) {
+        munmap(p, round_up(bytes, huge_page));
+    }
+}
+
+void* remap_huge(void* p, std::size_t old_bytes, std::size_t new_bytes) {
+    const std::size_t old_size = round_up(old_bytes, huge_page);
+    const std::size_t new_size = round_up(new_bytes, huge_page);
+    if (old_size == new_size) {  // ainda cabe nas páginas grandes já mapeadas
+        return p;
+    }
+    // encolher, ou crescer sobre o espaço livre logo após a região.
+    if (mremap(p, old_size, new_size, 0) != MAP_FAILED) {
+        return p;
+    }
+    // move as páginas, sem copiar os dados, para uma nova região alinhada a
+    // 2 MiB (que 'MREMAP_FIXED' substitui).
+    void* target = map_huge(new_bytes);
+    void* q = mremap(p, old_size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED,
+                     target);
+    if (q == MAP_FAILED) {  // por exemplo, 'MAP_HUGETLB' num kernel antigo
+        std::memcpy(target, p, old_size);
+        munmap(p, old_size);
+        return target;
+    }
+    return q;
+}
+
+void* map_numa(std::size_t bytes, int node) {
+    void* p = map_anonymous(bytes);
+    if (p == nullptr) {
+        throw std::bad_alloc{};
+    }
+    // a política vale para as páginas ainda não tocadas, ou seja, todas:
+    // 'mmap' não aloca memória física até o primeiro acesso.
+    unsigned long mask = 0;
+    if (node >= 0 && node < int(8 * sizeof(mask))) {
+        mask = 1ul << node;
+        syscall(SYS_mbind, p, bytes, MPOL_PREFERRED, &mask, 8 * sizeof(mask),
+                0);
+    } else {
+        syscall(SYS_mbind, p, bytes, MPOL_LOCAL, nullptr, 0, 0);
+    }
+    return p;
+}
+
+void unmap_numa(void* p, std::size_t bytes) {
+    if (p != nullptr) {
+        munmap(p, bytes == 0 ? 1 : bytes);
+    }
+}
+
+void* remap_numa(void* p, std::size_t old_bytes, std::size_t new_bytes) {
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    const std::size_t old_size = round_up(old_bytes == 0 ? 1 : old_bytes, page);
+    const std::size_t new_size = round_up(new_bytes == 0 ? 1 : new_bytes, page);
+    if (old_size == new_size) {
+        return p;
+    }
+    void* q = mremap(p, old_size, new_size, MREMAP_MAYMOVE);
+    if (q == MAP_FAILED) {
+        throw std::bad_alloc{};
+    }
+    return q;
+}
+
+}  // namespace memory::detail
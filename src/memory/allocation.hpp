@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// políticas de alocação para os 'Vector' dos capítulos. cada 'Vector' recebe a
+// política como parâmetro de template, então a escolha é feita em tempo de
+// compilação e não custa nada em tempo de execução:
+//
+//     capitulo_6::Vector<memory::HugePage<>> v(1 << 24);
+//
+// uma política é um tipo com duas funções estáticas, 'allocate(bytes)' e
+// 'deallocate(p, bytes)'. 'deallocate' recebe o mesmo tamanho pedido em
+// 'allocate', o que permite liberar com 'munmap' sem guardar o tamanho.
+//
+// uma política pode ainda ter 'reallocate(p, old_bytes, new_bytes)', que muda
+// o tamanho de um bloco preservando o seu conteúdo, como 'realloc': de
+// preferência no mesmo lugar, ou movendo as páginas com 'mremap', sem copiar.
+namespace memory {
+
+template <typename P>
+concept AllocationPolicy = requires(std::size_t bytes, void* p) {
+    { P::allocate(bytes) } -> std::same_as<void*>;
+    P::deallocate(p, bytes);
+};
+
+template <typename P>
+concept Reallocatable =
+    AllocationPolicy<P> && requires(std::size_t bytes, void* p) {
+        { P::reallocate(p, bytes, bytes) } -> std::same_as<void*>;
+    };
+
+constexpr std::size_t cache_line = 64;
+constexpr std::size_t huge_page = std::size_t{2} << 20;  // 2 MiB (x86-64)
+
+// o mesmo que 'new double[s]': alinhamento de 'alignof(std::max_align_t)'.
+struct NewDelete {
+    static void* allocate(std::size_t bytes) { return ::operator new(bytes); }
+    static void deallocate(void* p, std::size_t) { ::operator delete(p); }
+};
+
+// 'malloc'/'realloc'/'free': 'realloc' cresce o bloco no lugar quando há espaço
+// livre logo após ele e, para blocos grandes (acima de 'M_MMAP_THRESHOLD', 128
+// KiB por padrão, na glibc), que já vêm do 'mmap', usa 'mremap': as páginas
+// mudam de endereço sem que os dados sejam copiados.
+struct Malloc {
+    static void* allocate(std::size_t bytes) {
+        if (void* p = std::malloc(bytes == 0 ? 1 : bytes)) {
+            return p;
+        }
+        throw std::bad_alloc{};
+    }
+    static void deallocate(void* p, std::size_t) { std::free(p); }
+    static void* reallocate(void* p, std::size_t, std::size_t new_bytes) {
+        if (void* q = std::realloc(p, new_bytes == 0 ? 1 : new_bytes)) {
+            return q;
+        }
+        throw std::bad_alloc{};
+    }
+};
+
+// alinhado à linha de cache: as cargas SIMD de 64 bytes não atravessam duas
+// linhas, e dois 'Vector' nunca compartilham uma linha (falso
+// compartilhamento).
+template <std::size_t Alignment = cache_line>
+struct Aligned {
+    static_assert((Alignment & (Alignment - 1)) == 0,
+                  "o alinhamento deve ser uma potência de 2");
+    static void* allocate(std::size_t bytes) {
+        return ::operator new(bytes, std::align_val_t{Alignment});
+    }
+    static void deallocate(void* p, std::size_t) {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+};
+
+// funções não template de 'allocation.cpp'. lançam 'std::bad_alloc' em caso
+// de falha, como 'operator new'.
+namespace detail {
+void* map_huge(std::size_t bytes);
+void unmap_huge(void* p, std::size_t bytes);
+void* remap_huge(void* p, std::size_t old_bytes, std::size_t new_bytes);
+void* map_numa(std::size_t bytes, int node);
+void unmap_numa(void* p, std::size_t bytes);
+void* remap_numa(void* p, std::size_t old_bytes, std::size_t new_bytes);
+}  // namespace detail
+
+// abaixo de 'Threshold' bytes, igual a 'Aligned<>'. acima, a memória vem
+// direto do 'mmap', alinhada a 2 MiB: primeiro se tenta 'MAP_HUGETLB' (páginas
+// grandes reservadas pelo administrador em /proc/sys/vm/nr_hugepages) e, na
+// falta delas, 'madvise(MADV_HUGEPAGE)' pede ao kernel páginas grandes
+// transparentes. uma entrada da TLB passa a cobrir 2 MiB em vez de 4 KiB, o que
+// reduz as falhas de TLB de uma varredura de um buffer grande em ~512 vezes.
+template <std::size_t Threshold = huge_page>
+struct HugePage {
+    static void* allocate(std::size_t bytes) {
+        if (bytes < Threshold) {
+            return Aligned<>::allocate(bytes);
+        }
+        return detail::map_huge(bytes);
+    }
+    static void deallocate(void* p, std::size_t bytes) {
+        if (bytes < Threshold) {
+            Aligned<>::deallocate(p, bytes);
+        } else {
+            detail::unmap_huge(p, bytes);
+        }
+    }
+    // dos dois lados de 'Threshold', 'mremap'; ao cruzá-lo, a memória muda de
+    // origem e o conteúdo precisa ser copiado.
+    static void* reallocate(void* p, std::size_t old_bytes,
+                            std::size_t new_bytes) {
+        if (old_bytes >= Threshold && new_bytes >= Threshold) {
+            return detail::remap_huge(p, old_bytes, new_bytes);
+        }
+        void* q = allocate(new_bytes);
+        std::memcpy(q, p, std::min(old_bytes, new_bytes));
+        deallocate(p, old_bytes);
+        return q;
+    }
+};
+
+// memória mapeada com 'mbind(MPOL_PREFERRED)' no nó NUMA 'Node'; com 'Node'
+// negativo, 'MPOL_LOCAL' (o nó da cpu que tocar a página primeiro). como a
+// política é preferencial, um nó inexistente não é erro: o kernel usa outro.
+// sem suporte a NUMA no kernel, 'mbind' falha e a memória fica como está.
+template <int Node = -1>
+struct Numa {
+    static void* allocate(std::size_t bytes) {
+        return detail::map_numa(bytes, Node);
+    }
+    static void deallocate(void* p, std::size_t bytes) {
+        detail::unmap_numa(p, bytes);
+    }
+    // a política de 'mbind' pertence à região, e acompanha o 'mremap'.
+    static void* reallocate(void* p, std::size_t old_bytes,
+                            std::size_t new_bytes) {
+        return detail::remap_numa(p, old_bytes, new_bytes);
+    }
+};
+
+using DefaultAllocation = Aligned<>;
+
+// equivalentes de 'new T[n]' e 'delete[] p' sobre uma política: os elementos
+// são inicializados por padrão, ou seja, tipos triviais como 'double' ficam
+// sem valor definido, exatamente como com 'new double[n]'.
+template <typename T, AllocationPolicy Allocation>
+T* new_array(std::size_t n) {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    T* p = static_cast<T*>(Allocation::allocate(n * sizeof(T)));
+    try {
+        std::uninitialized_default_construct_n(p, n);
+    } catch (...) {
+        Allocation::deallocate(p, n * sizeof(T));
+        throw;
+    }
+    return p;
+}
+
+template <typename T, AllocationPolicy Allocation>
+void delete_array(T* p, std::size_t n) {
+    if (p == nullptr) {
+        return;
+    }
+    std::destroy_n(p, n);
+    Allocation::deallocate(p, n * sizeof(T));
+}
+
+// muda a capacidade de um array de 'new_array' de 'old_n' para 'new_n'
+// elementos, preservando os 'used' primeiros ('used <= min(old_n, new_n)').
+// para tipos triviais e políticas com 'reallocate', o bloco é estendido no
+// lugar ou tem as páginas remapeadas; senão, aloca, move e libera. os novos
+// elementos, como em 'new_array', são inicializados por padrão.
+template <typename T, AllocationPolicy Allocation>
+T* resize_array(T* p, std::size_t old_n, std::size_t new_n,
+                std::size_t used) {
+    if (p == nullptr) {
+        return new_array<T, Allocation>(new_n);
+    }
+    if constexpr (Reallocatable<Allocation> && std::is_trivial_v<T>) {
+        return static_cast<T*>(Allocation::reallocate(p, old_n * sizeof(T),
+                                                      new_n * sizeof(T)));
+    } else {
+        T* q = new_array<T, Allocation>(new_n);
+        try {
+            std::move(p, p + used, q);
+        } catch (...) {
+            delete_array<T, Allocation>(q, new_n);
+            throw;
+        }
+        delete_array<T, Allocation>(p, old_n);
+        return q;
+    }
+}
+
+}  // namespace memory
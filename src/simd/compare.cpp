@@ -0,0 +1,264 @@
+#include "simd/compare.hpp"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace simd {
+namespace {
+// ----- mismatch -----
+
+std::size_t mismatch_scalar(const double* a, const double* b, std::size_t n,
+                            std::size_t i = 0) {
+    for (; i < n; i++) {
+        if (!(a[i] == b[i])) {
+            return i;
+        }
+    }
+    return n;
+}
+
+__attribute__((target("sse2"))) std::size_t mismatch_sse2(const double* a,
+                                                          const double* b,
+                                                          std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const int eq = _mm_movemask_pd(
+            _mm_cmpeq_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        if (eq != 0x3) {
+            return i + __builtin_ctz(~eq);
+        }
+    }
+    return mismatch_scalar(a, b, n, i);
+}
+
+__attribute__((target("avx2"))) std::size_t mismatch_avx2(const double* a,
+                                                          const double* b,
+                                                          std::size_t n) {
+    std::size_t i = 0;
+    // dois registradores por iteração; a posição exata só é procurada no
+    // bloco em que há diferença.
+    for (; i + 8 <= n; i += 8) {
+        const __m256d e0 = _mm256_cmp_pd(_mm256_loadu_pd(a + i),
+                                         _mm256_loadu_pd(b + i), _CMP_EQ_OQ);
+        const __m256d e1 = _mm256_cmp_pd(_mm256_loadu_pd(a + i + 4),
+                                         _mm256_loadu_pd(b + i + 4),
+                                         _CMP_EQ_OQ);
+        const int eq = _mm256_movemask_pd(e0) | _mm256_movemask_pd(e1) << 4;
+        if (eq != 0xff) {
+            return i + __builtin_ctz(~eq);
+        }
+    }
+    for (; i + 4 <= n; i += 4) {
+        const int eq = _mm256_movemask_pd(_mm256_cmp_pd(
+            _mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _CMP_EQ_OQ));
+        if (eq != 0xf) {
+            return i + __builtin_ctz(~eq);
+        }
+    }
+    return mismatch_scalar(a, b, n, i);
+}
+
+__attribute__((target("avx512f"))) std::size_t mismatch_avx512(
+    const double* a, const double* b, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __mmask8 e0 = _mm512_cmp_pd_mask(
+            _mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), _CMP_EQ_OQ);
+        const __mmask8 e1 = _mm512_cmp_pd_mask(_mm512_loadu_pd(a + i + 8),
+                                               _mm512_loadu_pd(b + i + 8),
+                                               _CMP_EQ_OQ);
+        const unsigned eq = e0 | unsigned(e1) << 8;
+        if (eq != 0xffff) {
+            return i + __builtin_ctz(~eq);
+        }
+    }
+    for (; i < n; i += 8) {  // resto com carga mascarada, sem laço escalar
+        const __mmask8 m = n - i >= 8 ? 0xff : (1u << (n - i)) - 1;
+        const __mmask8 eq = _mm512_mask_cmp_pd_mask(
+            m, _mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i),
+            _CMP_EQ_OQ);
+        if (eq != m) {
+            return i + __builtin_ctz(~unsigned(eq));
+        }
+    }
+    return n;
+}
+
+// ----- hash -----
+
+constexpr int hash_lanes = 8;
+// chave inicial de cada 'lane', e o quanto ela avança a cada bloco.
+constexpr std::array<std::uint64_t, hash_lanes> hash_secret{
+    0xbe4ba423396cfeb8, 0x1cad21f72c81017c, 0xdb979083e96dd4de,
+    0x1f67b3b7a4a44072, 0x78e5c0cc4ee679cb, 0x2172ffcc7dd05a82,
+    0x8e2443f7744608b8, 0x4c263a81e69035e0};
+constexpr std::uint64_t hash_step = 0x9e3779b97f4a7c15;
+
+using Accumulators = std::array<std::uint64_t, hash_lanes>;
+
+// os bits de '-0.0' viram os de '0.0'.
+std::uint64_t normalized_bits(double d) {
+    const auto b = std::bit_cast<std::uint64_t>(d);
+    return (b << 1) == 0 ? 0 : b;
+}
+
+void hash_tail(const double* p, std::size_t first, std::size_t n,
+               Accumulators& acc) {
+    for (std::size_t i = first; i < n; i++) {
+        const std::size_t lane = i % hash_lanes;
+        const std::uint64_t b = normalized_bits(p[i]);
+        const std::uint64_t x =
+            b ^ (hash_secret[lane] + (i / hash_lanes) * hash_step);
+        acc[lane] += (x & 0xffffffff) * (x >> 32) + b;
+    }
+}
+
+void hash_scalar(const double* p, std::size_t n, Accumulators& acc) {
+    hash_tail(p, 0, n, acc);
+}
+
+__attribute__((target("sse2"))) void hash_sse2(const double* p, std::size_t n,
+                                               Accumulators& acc) {
+    __m128i a[4], key[4];
+    for (int r = 0; r < 4; r++) {
+        a[r] = _mm_setzero_si128();
+        key[r] = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(hash_secret.data() + 2 * r));
+    }
+    const __m128i step = _mm_set1_epi64x(hash_step);
+    const __m128d zero = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + hash_lanes <= n; i += hash_lanes) {
+        for (int r = 0; r < 4; r++) {
+            const __m128d d = _mm_loadu_pd(p + i + 2 * r);
+            const __m128i b = _mm_andnot_si128(
+                _mm_castpd_si128(_mm_cmpeq_pd(d, zero)), _mm_castpd_si128(d));
+            const __m128i x = _mm_xor_si128(b, key[r]);
+            const __m128i prod = _mm_mul_epu32(x, _mm_srli_epi64(x, 32));
+            a[r] = _mm_add_epi64(a[r], _mm_add_epi64(prod, b));
+            key[r] = _mm_add_epi64(key[r], step);
+        }
+    }
+    for (int r = 0; r < 4; r++) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc.data() + 2 * r), a[r]);
+    }
+    hash_tail(p, i, n, acc);
+}
+
+__attribute__((target("avx2"))) void hash_avx2(const double* p, std::size_t n,
+                                               Accumulators& acc) {
+    __m256i a0 = _mm256_setzero_si256(), a1 = a0;
+    __m256i k0 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(hash_secret.data()));
+    __m256i k1 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(hash_secret.data() + 4));
+    const __m256i step = _mm256_set1_epi64x(hash_step);
+    const __m256d zero = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + hash_lanes <= n; i += hash_lanes) {
+        const __m256d d0 = _mm256_loadu_pd(p + i);
+        const __m256d d1 = _mm256_loadu_pd(p + i + 4);
+        const __m256i b0 = _mm256_andnot_si256(
+            _mm256_castpd_si256(_mm256_cmp_pd(d0, zero, _CMP_EQ_OQ)),
+            _mm256_castpd_si256(d0));
+        const __m256i b1 = _mm256_andnot_si256(
+            _mm256_castpd_si256(_mm256_cmp_pd(d1, zero, _CMP_EQ_OQ)),
+            _mm256_castpd_si256(d1));
+        const __m256i x0 = _mm256_xor_si256(b0, k0);
+        const __m256i x1 = _mm256_xor_si256(b1, k1);
+        a0 = _mm256_add_epi64(
+            a0, _mm256_add_epi64(
+                    _mm256_mul_epu32(x0, _mm256_srli_epi64(x0, 32)), b0));
+        a1 = _mm256_add_epi64(
+            a1, _mm256_add_epi64(
+                    _mm256_mul_epu32(x1, _mm256_srli_epi64(x1, 32)), b1));
+        k0 = _mm256_add_epi64(k0, step);
+        k1 = _mm256_add_epi64(k1, step);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc.data()), a0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc.data() + 4), a1);
+    hash_tail(p, i, n, acc);
+}
+
+__attribute__((target("avx512f"))) void hash_avx512(const double* p,
+                                                    std::size_t n,
+                                                    Accumulators& acc) {
+    __m512i a = _mm512_setzero_si512();
+    __m512i key = _mm512_loadu_si512(hash_secret.data());
+    const __m512i step = _mm512_set1_epi64(hash_step);
+    const __m512d zero = _mm512_setzero_pd();
+    std::size_t i = 0;
+    for (; i + hash_lanes <= n; i += hash_lanes) {
+        const __m512d d = _mm512_loadu_pd(p + i);
+        const __m512i b = _mm512_maskz_mov_epi64(
+            ~_mm512_cmp_pd_mask(d, zero, _CMP_EQ_OQ), _mm512_castpd_si512(d));
+        const __m512i x = _mm512_xor_si512(b, key);
+        a = _mm512_add_epi64(
+            a, _mm512_add_epi64(_mm512_mul_epu32(x, _mm512_srli_epi64(x, 32)),
+                                b));
+        key = _mm512_add_epi64(key, step);
+    }
+    _mm512_storeu_si512(acc.data(), a);
+    hash_tail(p, i, n, acc);
+}
+
+// 'fmix64' do MurmurHash3.
+std::uint64_t fmix(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53;
+    h ^= h >> 33;
+    return h;
+}
+}  // namespace
+
+std::size_t mismatch(std::span<const double> a, std::span<const double> b,
+                     Isa isa) {
+    const std::size_t n = std::min(a.size(), b.size());
+    if (!supported(isa)) {
+        isa = best_isa();
+    }
+    switch (isa) {
+        case Isa::avx512:
+            return mismatch_avx512(a.data(), b.data(), n);
+        case Isa::avx2:
+            return mismatch_avx2(a.data(), b.data(), n);
+        case Isa::sse2:
+            return mismatch_sse2(a.data(), b.data(), n);
+        case Isa::scalar:
+            break;
+    }
+    return mismatch_scalar(a.data(), b.data(), n);
+}
+
+std::uint64_t hash(std::span<const double> v, Isa isa) {
+    Accumulators acc{};
+    if (!supported(isa)) {
+        isa = best_isa();
+    }
+    switch (isa) {
+        case Isa::avx512:
+            hash_avx512(v.data(), v.size(), acc);
+            break;
+        case Isa::avx2:
+            hash_avx2(v.data(), v.size(), acc);
+            break;
+        case Isa::sse2:
+            hash_sse2(v.data(), v.size(), acc);
+            break;
+        case Isa::scalar:
+            hash_scalar(v.data(), v.size(), acc);
+            break;
+    }
+    std::uint64_t h = fmix(v.size() * hash_step);
+    for (std::uint64_t a : acc) {
+        h = fmix(h ^ a);
+    }
+    return h;
+}
+
+}  // namespace simd
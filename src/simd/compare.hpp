@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "simd/isa.hpp"
+
+// comparação e hash de arrays de 'double' pelo conteúdo, um registrador SIMD
+// por vez, para que comparar ou usar como chave um vetor de milhares de
+// elementos não seja um laço escalar elemento a elemento.
+namespace simd {
+
+// índice do primeiro 'i' com '!(a[i] == b[i])', ou 'min(a.size(), b.size())'.
+// a igualdade é a de ponto flutuante (como 'memcmp', mas com '0.0 == -0.0' e
+// 'NaN' diferente de tudo), e não a dos bits.
+std::size_t mismatch(std::span<const double> a, std::span<const double> b,
+                     Isa isa = best_isa());
+
+// hash de 64 bits do conteúdo, compatível com a igualdade acima ('0.0' e
+// '-0.0' têm o mesmo hash). o resultado é o mesmo em todos os ISAs: oito
+// acumuladores independentes, um por 'lane', misturados a cada elemento por
+// uma multiplicação 32x32->64 (como no XXH3), com uma chave que muda a cada
+// bloco de oito elementos, para que a ordem dos elementos importe.
+std::uint64_t hash(std::span<const double> v, Isa isa = best_isa());
+
+}  // namespace simd
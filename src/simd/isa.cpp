@@ -0,0 +1,45 @@
+#include "simd/isa.hpp"
+
+namespace simd {
+
+bool supported(Isa isa) {
+    switch (isa) {
+        case Isa::scalar:
+            return true;
+        case Isa::sse2:
+            return __builtin_cpu_supports("sse2");
+        case Isa::avx2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::avx512:
+            return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+}
+
+Isa best_isa() {
+    static const Isa isa = [] {
+        for (auto candidate : {Isa::avx512, Isa::avx2, Isa::sse2}) {
+            if (supported(candidate)) {
+                return candidate;
+            }
+        }
+        return Isa::scalar;
+    }();
+    return isa;
+}
+
+std::string_view isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::scalar:
+            return "scalar";
+        case Isa::sse2:
+            return "sse2";
+        case Isa::avx2:
+            return "avx2";
+        case Isa::avx512:
+            return "avx512";
+    }
+    return "?";
+}
+
+}  // namespace simd
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string_view>
+
+// conjuntos de instruções SIMD selecionados em tempo de execução. as funções
+// especializadas são compiladas com '__attribute__((target(...)))' e só são
+// invocadas se a cpu de fato suportar o conjunto correspondente, de forma que
+// o binário continua válido numa máquina diferente daquela da compilação.
+namespace simd {
+
+enum class Isa { scalar, sse2, avx2, avx512 };
+
+Isa best_isa();  // detectado uma única vez, no primeiro uso.
+bool supported(Isa isa);
+std::string_view isa_name(Isa isa);
+
+}  // namespace simd
@@ -0,0 +1,275 @@
+#include "simd/reduce.hpp"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace simd {
+namespace {
+using Kernel = double (*)(const double*, std::size_t);
+
+// ----- soma rápida: quatro acumuladores independentes por ISA -----
+
+double sum_scalar(const double* p, std::size_t n) {
+    double a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        a0 += p[i];
+        a1 += p[i + 1];
+        a2 += p[i + 2];
+        a3 += p[i + 3];
+    }
+    for (; i < n; i++) {
+        a0 += p[i];
+    }
+    return (a0 + a1) + (a2 + a3);
+}
+
+__attribute__((target("sse2"))) double sum_sse2(const double* p,
+                                                std::size_t n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a0 = _mm_add_pd(a0, _mm_loadu_pd(p + i));
+        a1 = _mm_add_pd(a1, _mm_loadu_pd(p + i + 2));
+        a2 = _mm_add_pd(a2, _mm_loadu_pd(p + i + 4));
+        a3 = _mm_add_pd(a3, _mm_loadu_pd(p + i + 6));
+    }
+    __m128d a = _mm_add_pd(_mm_add_pd(a0, a1), _mm_add_pd(a2, a3));
+    double res = _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+    for (; i < n; i++) {
+        res += p[i];
+    }
+    return res;
+}
+
+__attribute__((target("avx2"))) double sum_avx2(const double* p,
+                                                std::size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(p + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(p + i + 4));
+        a2 = _mm256_add_pd(a2, _mm256_loadu_pd(p + i + 8));
+        a3 = _mm256_add_pd(a3, _mm256_loadu_pd(p + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(p + i));
+    }
+    __m256d a = _mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3));
+    __m128d h = _mm_add_pd(_mm256_castpd256_pd128(a),
+                           _mm256_extractf128_pd(a, 1));
+    double res = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+    for (; i < n; i++) {
+        res += p[i];
+    }
+    return res;
+}
+
+__attribute__((target("avx512f"))) double sum_avx512(const double* p,
+                                                     std::size_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        a0 = _mm512_add_pd(a0, _mm512_loadu_pd(p + i));
+        a1 = _mm512_add_pd(a1, _mm512_loadu_pd(p + i + 8));
+        a2 = _mm512_add_pd(a2, _mm512_loadu_pd(p + i + 16));
+        a3 = _mm512_add_pd(a3, _mm512_loadu_pd(p + i + 24));
+    }
+    for (; i < n; i += 8) {  // resto com carga mascarada, sem laço escalar
+        __mmask8 m = n - i >= 8 ? 0xff : (1u << (n - i)) - 1;
+        a0 = _mm512_add_pd(a0, _mm512_maskz_loadu_pd(m, p + i));
+    }
+    return _mm512_reduce_add_pd(
+        _mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+}
+
+// ----- soma compensada de Kahan: uma compensação por 'lane' -----
+
+// combina as somas parciais de cada 'lane' (e suas compensações) também com
+// Kahan, para não perder no final a precisão obtida no laço.
+struct Kahan {
+    double s{0};
+    double c{0};
+    void add(double x) {
+        double y = x - c;
+        double t = s + y;
+        c = (t - s) - y;
+        s = t;
+    }
+};
+
+double sum_kahan_scalar(const double* p, std::size_t n) {
+    Kahan k;
+    for (std::size_t i = 0; i < n; i++) {
+        k.add(p[i]);
+    }
+    return k.s;
+}
+
+__attribute__((target("sse2"))) double sum_kahan_sse2(const double* p,
+                                                      std::size_t n) {
+    __m128d s = _mm_setzero_pd(), c = s;
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d y = _mm_sub_pd(_mm_loadu_pd(p + i), c);
+        __m128d t = _mm_add_pd(s, y);
+        c = _mm_sub_pd(_mm_sub_pd(t, s), y);
+        s = t;
+    }
+    alignas(16) double ls[2], lc[2];
+    _mm_store_pd(ls, s);
+    _mm_store_pd(lc, c);
+    Kahan k;
+    for (int l = 0; l < 2; l++) {
+        k.add(ls[l]);
+        k.add(-lc[l]);
+    }
+    for (; i < n; i++) {
+        k.add(p[i]);
+    }
+    return k.s;
+}
+
+__attribute__((target("avx2"))) double sum_kahan_avx2(const double* p,
+                                                      std::size_t n) {
+    // dois pares (s, c) independentes, para esconder a latência da cadeia.
+    __m256d s0 = _mm256_setzero_pd(), c0 = s0, s1 = s0, c1 = s0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d y0 = _mm256_sub_pd(_mm256_loadu_pd(p + i), c0);
+        __m256d y1 = _mm256_sub_pd(_mm256_loadu_pd(p + i + 4), c1);
+        __m256d t0 = _mm256_add_pd(s0, y0);
+        __m256d t1 = _mm256_add_pd(s1, y1);
+        c0 = _mm256_sub_pd(_mm256_sub_pd(t0, s0), y0);
+        c1 = _mm256_sub_pd(_mm256_sub_pd(t1, s1), y1);
+        s0 = t0;
+        s1 = t1;
+    }
+    alignas(32) double ls[8], lc[8];
+    _mm256_store_pd(ls, s0);
+    _mm256_store_pd(ls + 4, s1);
+    _mm256_store_pd(lc, c0);
+    _mm256_store_pd(lc + 4, c1);
+    Kahan k;
+    for (int l = 0; l < 8; l++) {
+        k.add(ls[l]);
+        k.add(-lc[l]);
+    }
+    for (; i < n; i++) {
+        k.add(p[i]);
+    }
+    return k.s;
+}
+
+__attribute__((target("avx512f"))) double sum_kahan_avx512(const double* p,
+                                                           std::size_t n) {
+    __m512d s0 = _mm512_setzero_pd(), c0 = s0, s1 = s0, c1 = s0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d y0 = _mm512_sub_pd(_mm512_loadu_pd(p + i), c0);
+        __m512d y1 = _mm512_sub_pd(_mm512_loadu_pd(p + i + 8), c1);
+        __m512d t0 = _mm512_add_pd(s0, y0);
+        __m512d t1 = _mm512_add_pd(s1, y1);
+        c0 = _mm512_sub_pd(_mm512_sub_pd(t0, s0), y0);
+        c1 = _mm512_sub_pd(_mm512_sub_pd(t1, s1), y1);
+        s0 = t0;
+        s1 = t1;
+    }
+    alignas(64) double ls[16], lc[16];
+    _mm512_store_pd(ls, s0);
+    _mm512_store_pd(ls + 8, s1);
+    _mm512_store_pd(lc, c0);
+    _mm512_store_pd(lc + 8, c1);
+    Kahan k;
+    for (int l = 0; l < 16; l++) {
+        k.add(ls[l]);
+        k.add(-lc[l]);
+    }
+    for (; i < n; i++) {
+        k.add(p[i]);
+    }
+    return k.s;
+}
+
+// ----- seleção do kernel -----
+
+Kernel fast_kernel(Isa isa) {
+    switch (isa) {
+        case Isa::avx512:
+            return sum_avx512;
+        case Isa::avx2:
+            return sum_avx2;
+        case Isa::sse2:
+            return sum_sse2;
+        case Isa::scalar:
+            break;
+    }
+    return sum_scalar;
+}
+
+Kernel kahan_kernel(Isa isa) {
+    switch (isa) {
+        case Isa::avx512:
+            return sum_kahan_avx512;
+        case Isa::avx2:
+            return sum_kahan_avx2;
+        case Isa::sse2:
+            return sum_kahan_sse2;
+        case Isa::scalar:
+            break;
+    }
+    return sum_kahan_scalar;
+}
+
+// blocos pequenos o suficiente para que o erro dentro de cada um seja
+// desprezível, grandes o suficiente para amortizar a recursão.
+constexpr std::size_t pairwise_block = 512;
+
+double sum_pairwise(const double* p, std::size_t n, Kernel kernel) {
+    if (n <= pairwise_block) {
+        return kernel(p, n);
+    }
+    // divide num múltiplo do bloco, para manter as cargas alinhadas entre si.
+    std::size_t half = (n / 2 + pairwise_block - 1) / pairwise_block *
+                       pairwise_block;
+    return sum_pairwise(p, half, kernel) +
+           sum_pairwise(p + half, n - half, kernel);
+}
+
+double sum_serial(const double* p, std::size_t n, Summation mode, Isa isa) {
+    switch (mode) {
+        case Summation::kahan:
+            return kahan_kernel(isa)(p, n);
+        case Summation::pairwise:
+            return sum_pairwise(p, n, fast_kernel(isa));
+        case Summation::fast:
+            break;
+    }
+    return fast_kernel(isa)(p, n);
+}
+
+// tamanho fixo dos blocos do caminho paralelo: o resultado não depende do
+// número de threads nem da ordem em que terminam.
+constexpr std::size_t parallel_chunk = 1 << 16;
+}  // namespace
+
+double sum(std::span<const double> v, const SumOptions& options) {
+    const Isa isa = supported(options.isa) ? options.isa : best_isa();
+    const std::size_t n = v.size();
+    if (options.parallel_threshold == 0 || n < options.parallel_threshold) {
+        return sum_serial(v.data(), n, options.mode, isa);
+    }
+    const std::size_t chunks = (n + parallel_chunk - 1) / parallel_chunk;
+    std::vector<double> partial(chunks);
+#pragma omp parallel for schedule(static)
+    for (std::size_t c = 0; c < chunks; c++) {
+        const std::size_t first = c * parallel_chunk;
+        const std::size_t len = std::min(parallel_chunk, n - first);
+        partial[c] = sum_serial(v.data() + first, len, options.mode, isa);
+    }
+    return sum_serial(partial.data(), chunks, options.mode, isa);
+}
+
+}  // namespace simd
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "simd/isa.hpp"
+
+// motor de redução (soma) de arrays de 'double'. o laço ingênuo
+// 'for (auto& i : v) res += i;' é limitado pela latência da cadeia de
+// dependências das somas: cada adição espera o resultado da anterior. aqui se
+// usam vários acumuladores independentes por registrador SIMD, o que permite
+// que a cpu mantenha várias adições em andamento ao mesmo tempo.
+namespace simd {
+
+enum class Summation {
+    fast,      // vários acumuladores; a ordem das somas difere do laço serial
+    kahan,     // soma compensada de Kahan em cada 'lane'
+    pairwise,  // soma em árvore sobre blocos: erro O(log n) em vez de O(n)
+};
+
+struct SumOptions {
+    Summation mode{Summation::fast};
+    Isa isa{best_isa()};
+    // acima deste número de elementos, os blocos são somados em paralelo com
+    // OpenMP. 0 desabilita o caminho paralelo.
+    std::size_t parallel_threshold{1 << 18};
+};
+
+double sum(std::span<const double> v, const SumOptions& options = {});
+
+}  // namespace simd
@@ -0,0 +1,179 @@
+#include "simd/sentinel.hpp"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace {
+// os laços usam '__builtin_popcount'/'__builtin_ctz' em vez de funções
+// auxiliares: uma função sem o mesmo atributo 'target' não pode ser expandida
+// dentro das funções especializadas, e custaria uma chamada por bloco.
+
+template <std::size_t Bytes, typename T>
+const T* align_down(const T* p) {
+    return reinterpret_cast<const T*>(reinterpret_cast<std::uintptr_t>(p) &
+                                      ~std::uintptr_t{Bytes - 1});
+}
+
+template <bool Count, typename T>
+ScanResult scan_scalar(const T* p, T value, T sentinel) {
+    std::size_t count = 0;
+    const T* q = p;
+    for (; *q != sentinel; ++q) {
+        if (Count && *q == value) {
+            ++count;
+        }
+    }
+    return {count, static_cast<std::size_t>(q - p)};
+}
+
+template <typename T>
+__attribute__((target("sse2"))) unsigned eq_mask_sse2(__m128i x, __m128i y) {
+    __m128i e = _mm_cmpeq_epi32(x, y);
+    if constexpr (sizeof(T) == 4) {
+        return _mm_movemask_ps(_mm_castsi128_ps(e));
+    } else {
+        // SSE2 não possui comparação de 64 bits: as duas metades de 32 bits
+        // precisam ser iguais.
+        e = _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_movemask_pd(_mm_castsi128_pd(e));
+    }
+}
+
+template <bool Count, typename T>
+__attribute__((target("sse2"))) ScanResult scan_sse2(const T* p, T value,
+                                                     T sentinel) {
+    constexpr int lanes = 16 / sizeof(T);
+    const __m128i vv = sizeof(T) == 4 ? _mm_set1_epi32(value)
+                                      : _mm_set1_epi64x(value);
+    const __m128i vs = sizeof(T) == 4 ? _mm_set1_epi32(sentinel)
+                                      : _mm_set1_epi64x(sentinel);
+    const T* base = align_down<16>(p);
+    unsigned valid = ~0u << (p - base);  // ignora os elementos antes de 'p'
+    ScanResult result{0, 0};
+    while (true) {
+        __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(base));
+        unsigned stop = eq_mask_sse2<T>(x, vs) & valid;
+        unsigned hit = Count ? eq_mask_sse2<T>(x, vv) & valid : 0;
+        if (stop) {  // sentinela neste bloco: conta só o que vem antes dele
+            result.count += __builtin_popcount(hit & ((stop & -stop) - 1));
+            result.length = (base - p) + __builtin_ctz(stop);
+            return result;
+        }
+        result.count += __builtin_popcount(hit);
+        base += lanes;
+        valid = ~0u;
+    }
+}
+
+template <typename T>
+__attribute__((target("avx2"))) unsigned eq_mask_avx2(__m256i x, __m256i y) {
+    if constexpr (sizeof(T) == 4) {
+        __m256i e = _mm256_cmpeq_epi32(x, y);
+        return _mm256_movemask_ps(_mm256_castsi256_ps(e));
+    } else {
+        __m256i e = _mm256_cmpeq_epi64(x, y);
+        return _mm256_movemask_pd(_mm256_castsi256_pd(e));
+    }
+}
+
+template <bool Count, typename T>
+__attribute__((target("avx2"))) ScanResult scan_avx2(const T* p, T value,
+                                                     T sentinel) {
+    constexpr int lanes = 32 / sizeof(T);
+    const __m256i vv = sizeof(T) == 4 ? _mm256_set1_epi32(value)
+                                      : _mm256_set1_epi64x(value);
+    const __m256i vs = sizeof(T) == 4 ? _mm256_set1_epi32(sentinel)
+                                      : _mm256_set1_epi64x(sentinel);
+    const T* base = align_down<32>(p);
+    unsigned valid = ~0u << (p - base);
+    ScanResult result{0, 0};
+    while (true) {
+        __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(base));
+        unsigned stop = eq_mask_avx2<T>(x, vs) & valid;
+        unsigned hit = Count ? eq_mask_avx2<T>(x, vv) & valid : 0;
+        if (stop) {  // sentinela neste bloco: conta só o que vem antes dele
+            result.count += __builtin_popcount(hit & ((stop & -stop) - 1));
+            result.length = (base - p) + __builtin_ctz(stop);
+            return result;
+        }
+        result.count += __builtin_popcount(hit);
+        base += lanes;
+        valid = ~0u;
+    }
+}
+
+template <typename T>
+__attribute__((target("avx512f"))) unsigned eq_mask_avx512(__m512i x,
+                                                           __m512i y) {
+    if constexpr (sizeof(T) == 4) {
+        return _mm512_cmpeq_epi32_mask(x, y);
+    } else {
+        return _mm512_cmpeq_epi64_mask(x, y);
+    }
+}
+
+template <bool Count, typename T>
+__attribute__((target("avx512f"))) ScanResult scan_avx512(const T* p,
+                                                          T value,
+                                                          T sentinel) {
+    constexpr int lanes = 64 / sizeof(T);
+    const __m512i vv = sizeof(T) == 4 ? _mm512_set1_epi32(value)
+                                      : _mm512_set1_epi64(value);
+    const __m512i vs = sizeof(T) == 4 ? _mm512_set1_epi32(sentinel)
+                                      : _mm512_set1_epi64(sentinel);
+    const T* base = align_down<64>(p);
+    unsigned valid = ~0u << (p - base);
+    ScanResult result{0, 0};
+    while (true) {
+        __m512i x = _mm512_load_si512(base);
+        unsigned stop = eq_mask_avx512<T>(x, vs) & valid;
+        unsigned hit = Count ? eq_mask_avx512<T>(x, vv) & valid : 0;
+        if (stop) {  // sentinela neste bloco: conta só o que vem antes dele
+            result.count += __builtin_popcount(hit & ((stop & -stop) - 1));
+            result.length = (base - p) + __builtin_ctz(stop);
+            return result;
+        }
+        result.count += __builtin_popcount(hit);
+        base += lanes;
+        valid = ~0u;
+    }
+}
+
+template <bool Count, typename T>
+ScanResult scan(const T* p, T value, T sentinel, Isa isa) {
+    if (!supported(isa)) {
+        isa = best_isa();
+    }
+    switch (isa) {
+        case Isa::avx512:
+            return scan_avx512<Count>(p, value, sentinel);
+        case Isa::avx2:
+            return scan_avx2<Count>(p, value, sentinel);
+        case Isa::sse2:
+            return scan_sse2<Count>(p, value, sentinel);
+        case Isa::scalar:
+            break;
+    }
+    return scan_scalar<Count>(p, value, sentinel);
+}
+}  // namespace
+
+ScanResult count_until_sentinel(const std::int32_t* p, std::int32_t value,
+                                std::int32_t sentinel, Isa isa) {
+    return scan<true>(p, value, sentinel, isa);
+}
+ScanResult count_until_sentinel(const std::int64_t* p, std::int64_t value,
+                                std::int64_t sentinel, Isa isa) {
+    return scan<true>(p, value, sentinel, isa);
+}
+
+std::size_t find_sentinel(const std::int32_t* p, std::int32_t sentinel,
+                          Isa isa) {
+    return scan<false>(p, sentinel, sentinel, isa).length;
+}
+std::size_t find_sentinel(const std::int64_t* p, std::int64_t sentinel,
+                          Isa isa) {
+    return scan<false>(p, sentinel, sentinel, isa).length;
+}
+
+}  // namespace simd
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "simd/isa.hpp"
+
+// varredura de buffers no estilo C terminados por um valor sentinela
+// ('while (*pv) { if (*pv == val) ++count; ++pv; }'), processando um
+// registrador SIMD inteiro por vez.
+//
+// as cargas são sempre alinhadas ao tamanho do registrador: uma carga alinhada
+// nunca atravessa uma fronteira de página, então ler além do sentinela (dentro
+// do mesmo registrador) não pode causar uma falha de página, mesmo que o
+// buffer termine exatamente no fim da página. é a mesma técnica de 'strlen'.
+// o ponteiro deve estar alinhado ao tamanho do elemento.
+namespace simd {
+
+struct ScanResult {
+    std::size_t count;   // ocorrências de 'value' antes do sentinela
+    std::size_t length;  // posição do sentinela, relativa ao início
+};
+
+ScanResult count_until_sentinel(const std::int32_t* p, std::int32_t value,
+                                std::int32_t sentinel = 0,
+                                Isa isa = best_isa());
+ScanResult count_until_sentinel(const std::int64_t* p, std::int64_t value,
+                                std::int64_t sentinel = 0,
+                                Isa isa = best_isa());
+
+std::size_t find_sentinel(const std::int32_t* p, std::int32_t sentinel = 0,
+                          Isa isa = best_isa());
+std::size_t find_sentinel(const std::int64_t* p, std::int64_t sentinel = 0,
+                          Isa isa = best_isa());
+
+}  // namespace simd
@@ -0,0 +1,96 @@
+#include "simd/state_machine.hpp"
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+namespace simd {
+namespace {
+void step_scalar(std::uint8_t* s, std::size_t n, const std::uint8_t* next) {
+    for (std::size_t i = 0; i < n; i++) {
+        s[i] = next[s[i]];
+    }
+}
+
+// 'pshufb' é do SSSE3, não do SSE2: 'Isa::sse2' só o usa se a cpu o tiver.
+__attribute__((target("ssse3"))) void step_ssse3(std::uint8_t* s,
+                                                 std::size_t n,
+                                                 const std::uint8_t* next) {
+    const __m128i table =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(next));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        auto* p = reinterpret_cast<__m128i*>(s + i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(table, _mm_loadu_si128(p)));
+    }
+    for (; i < n; i++) {
+        s[i] = next[s[i]];
+    }
+}
+
+// 'vpshufb' consulta cada bloco de 128 bits separadamente: 'next' traz a
+// tabela repetida em cada bloco.
+__attribute__((target("avx2"))) void step_avx2(std::uint8_t* s, std::size_t n,
+                                               const std::uint8_t* next) {
+    const __m256i table =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next));
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto* p = reinterpret_cast<__m256i*>(s + i);
+        _mm256_storeu_si256(p,
+                            _mm256_shuffle_epi8(table, _mm256_loadu_si256(p)));
+    }
+    for (; i < n; i++) {
+        s[i] = next[s[i]];
+    }
+}
+
+__attribute__((target("avx512f,avx512bw"))) void step_avx512(
+    std::uint8_t* s, std::size_t n, const std::uint8_t* next) {
+    const __m512i table = _mm512_loadu_si512(next);
+    for (std::size_t i = 0; i < n; i += 64) {  // resto com carga mascarada
+        const __mmask64 m = n - i >= 64 ? ~__mmask64{0}
+                                        : (__mmask64{1} << (n - i)) - 1;
+        __m512i x = _mm512_maskz_loadu_epi8(m, s + i);
+        _mm512_mask_storeu_epi8(s + i, m, _mm512_shuffle_epi8(table, x));
+    }
+}
+}  // namespace
+
+void step_states(std::span<std::uint8_t> states,
+                 std::span<const std::uint8_t> next, Isa isa) {
+    std::uint8_t* s = states.data();
+    const std::size_t n = states.size();
+    if (next.size() > 16) {  // a tabela não cabe num registrador
+        step_scalar(s, n, next.data());
+        return;
+    }
+    // estende a tabela a 16 entradas e a repete quatro vezes: 64 bytes, o
+    // tamanho de um registrador de 512 bits.
+    alignas(64) std::uint8_t table[64]{};
+    for (int block = 0; block < 64; block += 16) {
+        std::ranges::copy(next, table + block);
+    }
+    if (!supported(isa)) {
+        isa = best_isa();
+    }
+    switch (isa) {
+        case Isa::avx512:
+            if (__builtin_cpu_supports("avx512bw")) {
+                return step_avx512(s, n, table);
+            }
+            [[fallthrough]];
+        case Isa::avx2:
+            return step_avx2(s, n, table);
+        case Isa::sse2:
+            if (__builtin_cpu_supports("ssse3")) {
+                return step_ssse3(s, n, table);
+            }
+            break;
+        case Isa::scalar:
+            break;
+    }
+    step_scalar(s, n, table);
+}
+
+}  // namespace simd
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "simd/isa.hpp"
+#include "tables/lookup_table.hpp"
+
+// avanço em lote de máquinas de estados finitos descritas por um 'enum class'
+// (como 'capitulo_2::TrafficLight'). em vez de um 'switch' por entidade, os
+// estados ficam num array compacto de 'uint8_t' e a transição é uma consulta
+// a uma tabela 'next[estado]' gerada em tempo de compilação. com até 16
+// estados a tabela cabe num registrador, e 'pshufb' ('_mm_shuffle_epi8')
+// consulta 16, 32 ou 64 estados por instrução: o laço fica limitado pela
+// largura de banda da memória, sem nenhum desvio por entidade.
+namespace simd {
+
+// aplica 'states[i] = next[states[i]]' a todo o array. estados fora da tabela
+// ('states[i] >= next.size()') têm resultado indefinido.
+void step_states(std::span<std::uint8_t> states,
+                 std::span<const std::uint8_t> next, Isa isa = best_isa());
+
+// tabela de transição de uma máquina de 'N' estados, '0' a 'N - 1', gerada
+// avaliando 'f(E(i))' em tempo de compilação:
+//
+//     constexpr auto next = simd::transitions<TrafficLight, 3>(
+//         [](TrafficLight t) { return ++t; });
+template <typename E, std::size_t N, typename F>
+    requires std::is_enum_v<E> && (N <= 256)
+consteval std::array<std::uint8_t, N> transitions(F f) {
+    return tables::make_table<N>(
+        [f](std::size_t i) { return static_cast<std::uint8_t>(f(E(i))); });
+}
+
+// estados de várias entidades da mesma máquina, um byte por entidade,
+// independente do tipo subjacente de 'E'.
+template <typename E, std::size_t N>
+    requires std::is_enum_v<E> && (N <= 256)
+class StateBatch {
+   public:
+    using Table = std::array<std::uint8_t, N>;
+
+    explicit StateBatch(std::size_t n, E initial = E{})
+        : states(n, static_cast<std::uint8_t>(initial)) {}
+
+    std::size_t size() const { return states.size(); }
+    E operator[](std::size_t i) const { return E(states[i]); }
+    void set(std::size_t i, E s) { states[i] = static_cast<std::uint8_t>(s); }
+
+    void step(const Table& next, Isa isa = best_isa()) {
+        step_states(states, next, isa);
+    }
+
+    std::span<std::uint8_t> data() { return states; }
+    std::span<const std::uint8_t> data() const { return states; }
+
+   private:
+    std::vector<std::uint8_t> states;
+};
+
+}  // namespace simd
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <numbers>
+
+// tabelas de consulta geradas em tempo de compilação a partir de funções
+// 'constexpr'. como são variáveis 'constexpr' de escopo de 'namespace', as
+// tabelas são inicializadas estaticamente: ficam em memória de apenas leitura
+// (.rodata), não custam nada na inicialização do programa e não estão sujeitas
+// ao problema de ordem de inicialização estática entre unidades de tradução.
+namespace tables {
+
+// 'make_table<N>(gen)' avalia 'gen(0)', ..., 'gen(N - 1)' em tempo de
+// compilação. por ser 'consteval', um gerador que não possa ser avaliado em
+// tempo de compilação é um erro de compilação, e não uma tabela calculada
+// silenciosamente em tempo de execução.
+template <std::size_t N, typename Generator>
+consteval auto make_table(Generator gen) {
+    std::array<decltype(gen(std::size_t{})), N> table{};
+    for (std::size_t i = 0; i < N; i++) {
+        table[i] = gen(i);
+    }
+    return table;
+}
+
+// as funções de <cmath> só passam a ser 'constexpr' em C++26; estas versões
+// servem apenas para gerar as tabelas, onde o custo não importa.
+namespace detail {
+constexpr double abs(double x) { return x < 0 ? -x : x; }
+
+constexpr double sqrt(double x) {
+    if (x <= 0) {
+        return 0;
+    }
+    double r = x < 1 ? 1 : x;
+    for (int i = 0; i < 200; i++) {  // Newton: converge quadraticamente
+        double next = 0.5 * (r + x / r);
+        if (next == r) {
+            break;
+        }
+        r = next;
+    }
+    return r;
+}
+
+// série de Taylor após a redução do argumento para [-pi, pi]; o erro absoluto
+// fica na ordem de 1e-15, suficiente para tabelas de 'twiddles'.
+constexpr double sin(double x) {
+    constexpr double two_pi = 2 * std::numbers::pi;
+    x -= two_pi * static_cast<long long>(x / two_pi);
+    if (x > std::numbers::pi) {
+        x -= two_pi;
+    } else if (x < -std::numbers::pi) {
+        x += two_pi;
+    }
+    double term = x;
+    double res = x;
+    for (int k = 1; k < 40 && abs(term) > 1e-20; k++) {
+        term *= -x * x / ((2 * k) * (2 * k + 1));
+        res += term;
+    }
+    return res;
+}
+
+constexpr double cos(double x) { return sin(x + std::numbers::pi / 2); }
+}  // namespace detail
+
+// avaliação de polinômio pelo método de Horner: c[0] + c[1]x + c[2]x² + ...
+template <std::size_t N>
+constexpr double horner(const std::array<double, N>& c, double x) {
+    double res = 0;
+    for (std::size_t i = N; i-- > 0;) {
+        res = res * x + c[i];
+    }
+    return res;
+}
+
+// coeficientes da série de Taylor de exp(x): 1/k!.
+template <std::size_t N>
+inline constexpr auto exp_coefficients = make_table<N>([](std::size_t k) {
+    double f = 1;
+    for (std::size_t i = 2; i <= k; i++) {
+        f *= i;
+    }
+    return 1 / f;
+});
+
+template <std::size_t N>
+inline constexpr auto square_table =
+    make_table<N>([](std::size_t i) { return double(i) * double(i); });
+
+template <std::size_t N>
+inline constexpr auto sqrt_table =
+    make_table<N>([](std::size_t i) { return detail::sqrt(double(i)); });
+
+// fatores de rotação de uma FFT de tamanho N: exp(-2 pi i k / N), k < N/2.
+template <std::size_t N>
+inline constexpr auto twiddles = make_table<N / 2>([](std::size_t k) {
+    const double angle = -2 * std::numbers::pi * double(k) / double(N);
+    return std::complex<double>{detail::cos(angle), detail::sin(angle)};
+});
+
+// sin(2 pi k / N) para k < N: ângulos quantizados em N passos.
+template <std::size_t N>
+inline constexpr auto sin_table = make_table<N>([](std::size_t k) {
+    return detail::sin(2 * std::numbers::pi * double(k) / double(N));
+});
+
+}  // namespace tables
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// mapa de chaves fixas com 'perfect hashing' gerado em tempo de compilação,
+// pelo método "hash and displace": as chaves são distribuídas em grupos
+// pequenos pelo seu hash, e para cada grupo se procura um deslocamento que
+// leve todas as suas chaves a posições ainda livres da tabela. a busca por uma
+// chave é então um único cálculo de hash, a leitura do deslocamento do seu
+// grupo, uma única posição consultada e uma única comparação, sem colisões a
+// percorrer. como o mapa é 'constexpr', não há alocação nem inicialização
+// dinâmica (o mapa fica em .rodata).
+//
+//     constexpr auto days = tables::make_perfect_hash_map(
+//         std::to_array<std::pair<std::string_view, int>>(
+//             {{"Janeiro", 31}, {"Fevereiro", 28}, ...}));
+//     days.find("Fevereiro");  // ponteiro para 28, ou nullptr
+namespace tables {
+
+namespace detail {
+// hash multiplicativo: os bits altos do produto dependem de todos os bits de
+// 'x', e são eles que escolhem grupo e posição.
+constexpr std::uint64_t multiply(std::uint64_t x) {
+    return x * 0x9e3779b97f4a7c15ULL;
+}
+
+// lê 'Bytes' bytes a partir de 'pos' em ordem 'little endian'. com o tamanho
+// fixo, o compilador reconhece a montagem como uma única carga; a mesma
+// função serve em tempo de compilação, onde não se pode reinterpretar os
+// bytes da 'string_view'.
+template <std::size_t Bytes>
+constexpr std::uint64_t load(std::string_view key, std::size_t pos) {
+    std::uint64_t word = 0;
+    for (std::size_t b = 0; b < Bytes; b++) {
+        word |= std::uint64_t(static_cast<unsigned char>(key[pos + b]))
+                << (8 * b);
+    }
+    return word;
+}
+
+// 8 bytes por vez; o resto é lido com cargas de tamanho fixo sobrepostas
+// (como em 'wyhash'), sem laço byte a byte.
+constexpr std::uint64_t perfect_hash(std::string_view key) {
+    const std::size_t n = key.size();
+    std::uint64_t h = multiply(n);
+    if (n >= 8) {
+        for (std::size_t i = 0; i + 8 < n; i += 8) {
+            h = multiply(h ^ load<8>(key, i));
+        }
+        return multiply(h ^ load<8>(key, n - 8));
+    }
+    if (n >= 4) {
+        return multiply(h ^ (load<4>(key, 0) << 32 | load<4>(key, n - 4)));
+    }
+    if (n > 0) {
+        return multiply(h ^ (load<1>(key, 0) << 16 | load<1>(key, n / 2) << 8 |
+                             load<1>(key, n - 1)));
+    }
+    return h;
+}
+
+template <typename Key>
+    requires std::is_integral_v<Key> || std::is_enum_v<Key>
+constexpr std::uint64_t perfect_hash(Key key) {
+    return multiply(static_cast<std::uint64_t>(key));
+}
+}  // namespace detail
+
+template <typename Key, typename Value, std::size_t N>
+class PerfectHashMap {
+    static_assert(N > 0 && N < std::numeric_limits<std::uint16_t>::max());
+
+   public:
+    using value_type = std::pair<Key, Value>;
+
+    // o dobro de posições e grupos de duas chaves, em média: a busca pelos
+    // deslocamentos termina rápido mesmo com milhares de chaves.
+    static constexpr std::size_t slot_count = std::bit_ceil(2 * N);
+    static constexpr std::size_t group_count = std::bit_ceil((N + 1) / 2);
+
+    consteval explicit PerfectHashMap(const std::array<value_type, N>& items)
+        : m_items{items} {
+        std::array<std::uint64_t, N> hashes{};
+        for (std::size_t i = 0; i < N; i++) {
+            hashes[i] = detail::perfect_hash(items[i].first);
+            for (std::size_t j = 0; j < i; j++) {
+                if (items[i].first == items[j].first) {
+                    throw std::invalid_argument{"chave repetida"};
+                }
+                if (hashes[i] == hashes[j]) {
+                    throw std::invalid_argument{"hash repetido"};
+                }
+            }
+        }
+        // grupos maiores primeiro, enquanto a tabela ainda está vazia.
+        std::array<std::size_t, group_count> size{};
+        std::array<std::size_t, group_count> order{};
+        for (std::size_t i = 0; i < N; i++) {
+            size[group(hashes[i])]++;
+        }
+        for (std::size_t g = 0; g < group_count; g++) {
+            order[g] = g;
+        }
+        std::ranges::sort(order, [&size](std::size_t a, std::size_t b) {
+            return size[a] > size[b];
+        });
+        m_slots.fill(empty);
+        for (std::size_t g : order) {
+            if (size[g] == 0) {
+                break;
+            }
+            place(g, hashes);
+        }
+    }
+
+    // a única posição em que 'key' pode estar.
+    constexpr const Value* find(const Key& key) const {
+        const std::uint64_t h = detail::perfect_hash(key);
+        const std::uint16_t i = m_slots[slot(h, m_displacement[group(h)])];
+        if (i == empty || !(m_items[i].first == key)) {
+            return nullptr;
+        }
+        return &m_items[i].second;
+    }
+    constexpr bool contains(const Key& key) const {
+        return find(key) != nullptr;
+    }
+    constexpr const Value& at(const Key& key) const {
+        if (const Value* v = find(key)) {
+            return *v;
+        }
+        throw std::out_of_range{"PerfectHashMap::at"};
+    }
+    // as chaves são fixas: não há inserção, e '[]' é o mesmo que 'at'.
+    constexpr const Value& operator[](const Key& key) const { return at(key); }
+
+    static constexpr std::size_t size() { return N; }
+    // iteração na ordem em que as chaves foram dadas.
+    constexpr auto begin() const { return m_items.begin(); }
+    constexpr auto end() const { return m_items.end(); }
+
+   private:
+    static constexpr std::uint16_t empty =
+        std::numeric_limits<std::uint16_t>::max();
+
+    // os bits altos do hash escolhem o grupo; a posição vem dos bits altos de
+    // um segundo produto, que muda com o deslocamento 'd'.
+    static constexpr std::size_t group(std::uint64_t h) {
+        if constexpr (group_count == 1) {
+            return 0;
+        } else {
+            return h >> (64 - std::countr_zero(group_count));
+        }
+    }
+    static constexpr std::size_t slot(std::uint64_t h, std::uint32_t d) {
+        return detail::multiply(h ^ d) >> (64 - std::countr_zero(slot_count));
+    }
+
+    // procura o menor deslocamento que leve as chaves do grupo 'g' a posições
+    // livres e distintas entre si.
+    constexpr void place(std::size_t g,
+                         const std::array<std::uint64_t, N>& hashes) {
+        for (std::uint32_t d = 0; d < (1u << 20); d++) {
+            bool ok = true;
+            std::size_t i = 0;
+            for (; i < N && ok; i++) {
+                if (group(hashes[i]) != g) {
+                    continue;
+                }
+                auto& s = m_slots[slot(hashes[i], d)];
+                if (s == empty) {
+                    s = static_cast<std::uint16_t>(i);
+                } else {
+                    ok = false;
+                }
+            }
+            if (ok) {
+                m_displacement[g] = d;
+                return;
+            }
+            // desfaz as posições ocupadas nesta tentativa.
+            for (std::size_t j = 0; j < i; j++) {
+                if (group(hashes[j]) == g &&
+                    m_slots[slot(hashes[j], d)] == j) {
+                    m_slots[slot(hashes[j], d)] = empty;
+                }
+            }
+        }
+        throw std::invalid_argument{"nenhum deslocamento sem colisões"};
+    }
+
+    std::array<value_type, N> m_items;
+    std::array<std::uint16_t, slot_count> m_slots{};
+    std::array<std::uint32_t, group_count> m_displacement{};
+};
+
+template <typename Key, typename Value, std::size_t N>
+consteval auto make_perfect_hash_map(
+    const std::array<std::pair<Key, Value>, N>& items) {
+    return PerfectHashMap<Key, Value, N>{items};
+}
+
+}  // namespace tables